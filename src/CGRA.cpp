@@ -20,6 +20,7 @@ using json = nlohmann::json;
  * 2. Depending on whether parameter a is true or false, decide whether to use paramCGRA.json or default parameters to initialize CGRA.
  * 3. init the CGRANode and CGRALink according to paramCGRA.json or default value.
  * 4. connect the CGRANode and CGRALink to Generate the CGRA.
+ * 5. compute the hop distances between the CGRANodes.
  */
 CGRA::CGRA(int t_rows, int t_columns,
 	   bool t_parameterizableCGRA,
@@ -29,6 +30,12 @@ CGRA::CGRA(int t_rows, int t_columns,
   m_rows = t_rows;
   m_columns = t_columns;
   m_FUCount = t_rows * t_columns;
+  m_parameterizableCGRA = t_parameterizableCGRA;
+  m_additionalFunc = t_additionalFunc;
+  m_regConstraint = -1;
+  m_ctrlMemConstraint = -1;
+  m_bypassConstraint = -1;
+  m_hopDistance = NULL;
   nodes = new CGRANode**[t_rows];
 
   //2. Depending on whether parameter a is true or false, decide whether to use paramCGRA.json or default parameters to initialize CGRA.
@@ -259,20 +266,26 @@ CGRA::CGRA(int t_rows, int t_columns,
       }
     }
   }
+
+  //5. compute the hop distances between the CGRANodes.
+  computeHopDistances();
 }
 
 void CGRA::setRegConstraint(int t_regConstraint) {
+  m_regConstraint = t_regConstraint;
   for (int i=0; i<m_rows; ++i)
     for (int j=0; j<m_columns; ++j)
       nodes[i][j]->setRegConstraint(t_regConstraint);
 }
 
 void CGRA::setBypassConstraint(int t_bypassConstraint) {
+  m_bypassConstraint = t_bypassConstraint;
   for (int i=0; i<m_LinkCount; ++i)
     links[i]->setBypassConstraint(t_bypassConstraint);
 }
 
 void CGRA::setCtrlMemConstraint(int t_ctrlMemConstraint) {
+  m_ctrlMemConstraint = t_ctrlMemConstraint;
   for (int i=0; i<m_rows; ++i)
     for (int j=0; j<m_columns; ++j)
       nodes[i][j]->setCtrlMemConstraint(t_ctrlMemConstraint);
@@ -293,6 +306,26 @@ void CGRA::constructMRRG(int t_II) {
     links[i]->constructMRRG(m_FUCount, t_II);
 }
 
+CGRA* CGRA::clone() {
+  CGRA* cgra = new CGRA(m_rows, m_columns, m_parameterizableCGRA,
+                        m_additionalFunc);
+  if (m_regConstraint != -1)
+    cgra->setRegConstraint(m_regConstraint);
+  if (m_ctrlMemConstraint != -1)
+    cgra->setCtrlMemConstraint(m_ctrlMemConstraint);
+  if (m_bypassConstraint != -1)
+    cgra->setBypassConstraint(m_bypassConstraint);
+  return cgra;
+}
+
+void CGRA::copyMRRGFrom(CGRA* t_cgra) {
+  for (int i=0; i<m_rows; ++i)
+    for (int j=0; j<m_columns; ++j)
+      nodes[i][j]->copyMRRGFrom(t_cgra->nodes[i][j]);
+  for (int i=0; i<m_LinkCount; ++i)
+    links[i]->copyMRRGFrom(t_cgra->links[i]);
+}
+
 CGRALink* CGRA::getLink(CGRANode* t_n1, CGRANode* t_n2) {
    for (int i=0; i<m_LinkCount; ++i) {
      if (links[i]->getSrc()==t_n1 and links[i]->getDst() == t_n2) {
@@ -307,3 +340,34 @@ CGRALink* CGRA::getLink(CGRANode* t_n1, CGRANode* t_n2) {
 int CGRA::getLinkCount() {
   return m_LinkCount;
 }
+
+void CGRA::computeHopDistances() {
+  m_hopDistance = new int*[m_FUCount];
+  for (int i=0; i<m_rows; ++i) {
+    for (int j=0; j<m_columns; ++j) {
+      CGRANode* src = nodes[i][j];
+      int* distance = new int[m_FUCount];
+      for (int k=0; k<m_FUCount; ++k)
+        distance[k] = m_FUCount;
+      distance[src->getID()] = 0;
+      list<CGRANode*> queue;
+      queue.push_back(src);
+      while (queue.size() != 0) {
+        CGRANode* current = queue.front();
+        queue.pop_front();
+        for (CGRALink* link: *(current->getOutLinks())) {
+          CGRANode* next = link->getDst();
+          if (link->isDisabled() or distance[next->getID()] != m_FUCount)
+            continue;
+          distance[next->getID()] = distance[current->getID()] + 1;
+          queue.push_back(next);
+        }
+      }
+      m_hopDistance[src->getID()] = distance;
+    }
+  }
+}
+
+int CGRA::getHopDistance(CGRANode* t_src, CGRANode* t_dst) {
+  return m_hopDistance[t_src->getID()][t_dst->getID()];
+}
@@ -34,6 +34,22 @@ class CGRA {
 		 */
     int m_columns;
 
+		/** the construction params and constraints of the CGRA, they are saved for clone()
+		 */
+    bool m_parameterizableCGRA;
+    map<string, list<int>*>* m_additionalFunc;
+    int m_regConstraint;
+    int m_ctrlMemConstraint;
+    int m_bypassConstraint;
+
+		/** the all-pairs hop distances over the enabled CGRALinks, m_hopDistance[src ID][dst ID], it is m_FUCount if dst is not reachable from src
+		 */
+    int** m_hopDistance;
+
+		/**The function to compute m_hopDistance with a BFS from every CGRANode, it is called once the CGRANodes and CGRALinks (including the disabled ones in paramCGRA.json) are constructed.
+		 */
+    void computeHopDistances();
+
   public:
 		
 		/**The constructor function of class CGRA
@@ -58,9 +74,35 @@ class CGRA {
 		 */
 		void constructMRRG(int t_II);
 
+		/**The function to create another CGRA with the same construction params and constraints, its MRRG is not constructed.
+		 * the mapping strategies running in parallel work on the clones, since the MRRG is saved in CGRANodes and CGRALinks.
+		 * @return : the pointer to the new CGRA
+		 */
+		CGRA* clone();
+
+		/**The function to copy the MRRG from a clone of this CGRA
+		 * this function traverse all CGRANodes and CGRALinks in CGRA,and call their copyMRRGFrom method with the ones of the same ID in t_cgra
+		 * @param t_cgra : the CGRA to copy from
+		 */
+		void copyMRRGFrom(CGRA* t_cgra);
+
+		/**The function to get the least number of CGRALinks data goes through from t_src to t_dst
+		 * it is an admissible estimate of the routing cost, since every hop takes at least one cycle.
+		 * @param t_src : the src CGRANode
+		 * @param t_dst : the dst CGRANode
+		 * @return : the hop distance, getFUCount() if t_dst is not reachable
+		 */
+		int getHopDistance(CGRANode* t_src, CGRANode* t_dst);
+
     int getRows() { return m_rows; }
     int getColumns() { return m_columns; }
 
+		/**The function to get the CGRANode by its ID, the ID of nodes[i][j] is i*columns+j.
+		 * @param t_id : the ID of the CGRANode
+		 * @return : the CGRANode
+		 */
+    CGRANode* getNode(int t_id) { return nodes[t_id/m_columns][t_id%m_columns]; }
+
 		/**The function to get CGRALink from CGRANode t_n1 to CGRANode t_n2
 		 * this function traverse each CGRALinks in CGRA to check if the src is t_n1 and dst is t_n2.
 		 * @param t_n1 : the src CGRANode
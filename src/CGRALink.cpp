@@ -19,7 +19,10 @@ CGRALink::CGRALink(int t_linkId) {
   m_bypassed = new bool[1];
   m_generatedOut = new bool[1];
   m_arrived = new bool[1];
+  m_cycleBoundary = 1;
   m_disabled = false;
+  m_isRecording = false;
+  m_recordedCtrlMemItems = 0;
 }
 
 void CGRALink::setCtrlMemConstraint(int t_ctrlMemConstraint) {
@@ -80,6 +83,31 @@ void CGRALink::constructMRRG(int t_CGRANodeCount, int t_II) {
   }
 }
 
+void CGRALink::copyMRRGFrom(CGRALink* t_cgraLink) {
+  if (m_cycleBoundary != t_cgraLink->m_cycleBoundary) {
+    m_cycleBoundary = t_cgraLink->m_cycleBoundary;
+    delete[] m_occupied;
+    m_occupied = new bool[m_cycleBoundary];
+    delete[] m_dfgNodes;
+    m_dfgNodes = new DFGNode*[m_cycleBoundary];
+    delete[] m_bypassed;
+    m_bypassed = new bool[m_cycleBoundary];
+    delete[] m_generatedOut;
+    m_generatedOut = new bool[m_cycleBoundary];
+    delete[] m_arrived;
+    m_arrived = new bool[m_cycleBoundary];
+  }
+  m_II = t_cgraLink->m_II;
+  m_currentCtrlMemItems = t_cgraLink->m_currentCtrlMemItems;
+  for (int i=0; i<m_cycleBoundary; ++i) {
+    m_occupied[i] = t_cgraLink->m_occupied[i];
+    m_dfgNodes[i] = t_cgraLink->m_dfgNodes[i];
+    m_bypassed[i] = t_cgraLink->m_bypassed[i];
+    m_generatedOut[i] = t_cgraLink->m_generatedOut[i];
+    m_arrived[i] = t_cgraLink->m_arrived[i];
+  }
+}
+
 bool CGRALink::satisfyBypassConstraint(int t_cycle, int t_II) {
   CGRANode* outCGRANode = getDst();
   // If no DFG node is mapped onto the outCGRANode.
@@ -207,6 +235,7 @@ void CGRALink::occupy(DFGNode* t_srcDFGNode, int t_cycle, int duration,
     t_cycle = 0;
   }
   for(int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=interval) {
+    recordCycle(cycle);
     m_dfgNodes[cycle] = t_srcDFGNode;
     m_occupied[cycle] = true;
     // Only set 'm_bypassed' as true if it is bypassed.
@@ -221,6 +250,7 @@ void CGRALink::occupy(DFGNode* t_srcDFGNode, int t_cycle, int duration,
       m_arrived[cycle] = true;
   }
   for(int cycle=t_cycle; cycle>=0; cycle-=interval) {
+    recordCycle(cycle);
     m_dfgNodes[cycle] = t_srcDFGNode;
     m_occupied[cycle] = true;
     // Only set 'm_bypassed' as true if it is bypassed.
@@ -243,6 +273,45 @@ void CGRALink::occupy(DFGNode* t_srcDFGNode, int t_cycle, int duration,
   cout<<"[DEBUG] occupy link["<<m_src->getID()<<"]-->["<<m_dst->getID()<<"] (bypass:"<<t_isBypass<<") dfgNode: "<<t_srcDFGNode->getID()<<" at cycle "<<t_cycle<<"\n";
 }
 
+void CGRALink::recordCycle(int t_cycle) {
+  if (!m_isRecording)
+    return;
+  m_recordedDFGNodes.push_back(make_pair(t_cycle, m_dfgNodes[t_cycle]));
+  m_recordedFlags.push_back(make_pair(&m_occupied[t_cycle],
+                                      m_occupied[t_cycle]));
+  m_recordedFlags.push_back(make_pair(&m_bypassed[t_cycle],
+                                      m_bypassed[t_cycle]));
+  m_recordedFlags.push_back(make_pair(&m_generatedOut[t_cycle],
+                                      m_generatedOut[t_cycle]));
+  m_recordedFlags.push_back(make_pair(&m_arrived[t_cycle],
+                                      m_arrived[t_cycle]));
+}
+
+void CGRALink::recordMRRGChanges() {
+  m_isRecording = true;
+  m_recordedCtrlMemItems = m_currentCtrlMemItems;
+  m_recordedFlags.clear();
+  m_recordedDFGNodes.clear();
+}
+
+void CGRALink::undoMRRGChanges() {
+  // The same cycle can be changed more than once, restore the oldest value.
+  for (list<pair<bool*, bool>>::reverse_iterator iter=m_recordedFlags.rbegin();
+      iter!=m_recordedFlags.rend(); ++iter)
+    *((*iter).first) = (*iter).second;
+  for (list<pair<int, DFGNode*>>::reverse_iterator
+      iter=m_recordedDFGNodes.rbegin(); iter!=m_recordedDFGNodes.rend(); ++iter)
+    m_dfgNodes[(*iter).first] = (*iter).second;
+  m_currentCtrlMemItems = m_recordedCtrlMemItems;
+  keepMRRGChanges();
+}
+
+void CGRALink::keepMRRGChanges() {
+  m_isRecording = false;
+  m_recordedFlags.clear();
+  m_recordedDFGNodes.clear();
+}
+
 DFGNode* CGRALink::getMappedDFGNode(int t_cycle) {
   if (t_cycle < 0) {
     return m_dfgNodes[m_II+t_cycle];
@@ -320,3 +389,7 @@ string CGRALink::getDirection(CGRANode* t_cgraNode) {
 void CGRALink::disable() {
   m_disabled = true;
 }
+
+bool CGRALink::isDisabled() {
+  return m_disabled;
+}
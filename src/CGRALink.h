@@ -71,8 +71,22 @@ class CGRALink
 		 */
     DFGNode** m_dfgNodes;
 
+		/** True means occupy() records the old values of what it changes, so that undoMRRGChanges() can restore them.
+		 * m_recordedCtrlMemItems : m_currentCtrlMemItems when the recording starts
+		 * m_recordedFlags : the changed entries of m_occupied, m_bypassed, m_generatedOut and m_arrived with their old values, in the order of the changes
+		 * m_recordedDFGNodes : the changed cycles of m_dfgNodes with their old values, in the order of the changes
+		 */
+    bool m_isRecording;
+    int m_recordedCtrlMemItems;
+    list<pair<bool*, bool>> m_recordedFlags;
+    list<pair<int, DFGNode*>> m_recordedDFGNodes;
+
     bool satisfyBypassConstraint(int, int);
 
+		/** record the old values of t_cycle before occupy() changes it, if m_isRecording.
+		 */
+    void recordCycle(int t_cycle);
+
   public:
 		/**The constructor function of class CGRALink
 		 * this function init CGRANode's ID according the params,other var is init by default value.
@@ -99,6 +113,11 @@ class CGRALink
 		 */
 		void constructMRRG(int t_CGRANodeCount, int t_II);
 
+		/**The function to copy the MRRG of another CGRALink with the same ID
+		 * @param t_cgraLink : the CGRALink to copy from
+		 */
+		void copyMRRGFrom(CGRALink* t_cgraLink);
+
     bool canOccupy(int, int);
     bool isOccupied(int);
     bool isOccupied(int, int, bool);
@@ -116,6 +135,14 @@ class CGRALink
 		 */
 		void occupy(DFGNode* t_srcDFGNode, int t_cycle, int duration, int t_II, bool t_isBypass, bool t_isGeneratedOut, bool t_isStaticElasticCGRA);
 
+		/**The functions to undo occupy() on this CGRALink, e.g., when a schedule fails half way.
+		 * recordMRRGChanges() starts recording the old values of what occupy() changes, undoMRRGChanges() restores them and keepMRRGChanges() forgets them, both stop the recording.
+		 * the registers occupy() allocates in m_dst are recorded by m_dst itself.
+		 */
+    void recordMRRGChanges();
+    void undoMRRGChanges();
+    void keepMRRGChanges();
+
     bool isBypass(int);
     string getDirection(CGRANode*);
 
@@ -137,6 +164,7 @@ class CGRALink
 		void setBypassConstraint(int t_bypassConstraint);
     int getBypassConstraint();
     void disable();
+    bool isDisabled();
 };
 
 #endif
@@ -26,6 +26,8 @@
 CGRANode::CGRANode(int t_id, int t_x, int t_y) {
   m_id = t_id;
   m_currentCtrlMemItems = 0;
+  m_isRecording = false;
+  m_recordedCtrlMemItems = 0;
   m_disabled = false;
   m_canStore = false;
   m_canLoad = false;
@@ -86,18 +88,18 @@ void CGRANode::allocateReg(int t_port_id, int t_cycle, int t_duration, int t_II)
     if (reg_occupied == false) {
       cout<<"[DEBUG] in allocateReg() t_cycle: "<<t_cycle<<"; i: "<<i<<" CGRA node: "<<this->getID()<<"; link: "<<t_port_id<<" duration "<<t_duration<<"\n";
       for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-        m_regs_timing[cycle][i] = t_port_id;
+        setReg(m_regs_timing, cycle, i, t_port_id);
         for (int d=0; d<t_duration; ++d) {
           if (cycle+d<m_cycleBoundary) {
             // assert(m_regs_duration[cycle+d][i] == -1);
-            m_regs_duration[cycle+d][i] = t_port_id;
+            setReg(m_regs_duration, cycle+d, i, t_port_id);
           }
         }
       }
       for (int cycle=t_cycle; cycle>=0; cycle-=t_II) {
-        m_regs_timing[cycle][i] = t_port_id;
+        setReg(m_regs_timing, cycle, i, t_port_id);
         for (int d=0; d<t_duration; ++d) {
-          m_regs_duration[cycle+d][i] = t_port_id;
+          setReg(m_regs_duration, cycle+d, i, t_port_id);
         }
       }
       allocated = true;
@@ -108,6 +110,13 @@ void CGRANode::allocateReg(int t_port_id, int t_cycle, int t_duration, int t_II)
   //assert(allocated);
 }
 
+void CGRANode::setReg(int** t_regs, int t_cycle, int t_reg, int t_portID) {
+  if (m_isRecording)
+    m_recordedRegs.push_back(make_pair(&t_regs[t_cycle][t_reg],
+                                       t_regs[t_cycle][t_reg]));
+  t_regs[t_cycle][t_reg] = t_portID;
+}
+
 int* CGRANode::getRegsAllocation(int t_cycle) {
   return m_regs_timing[t_cycle];
 }
@@ -168,6 +177,7 @@ void CGRANode::constructMRRG(int t_CGRANodeCount, int t_II) {
   m_cycleBoundary = t_CGRANodeCount*t_II*t_II; //give a big value
   m_currentCtrlMemItems = 0;
   m_registers.clear();
+  m_multicastArrivals.clear();
   // Delete all these local arrays to avoid memory leakage.
   if (m_dfgNodesWithOccupyStatus.size() > 0) {
     for (list<pair<DFGNode*, int>>* opts: m_dfgNodesWithOccupyStatus) {
@@ -191,6 +201,40 @@ void CGRANode::constructMRRG(int t_CGRANodeCount, int t_II) {
   }
 }
 
+void CGRANode::copyMRRGFrom(CGRANode* t_cgraNode) {
+  int cycleBoundary = t_cgraNode->m_cycleBoundary;
+  if ((int)m_dfgNodesWithOccupyStatus.size() != cycleBoundary) {
+    for (int i=0; i<(int)m_dfgNodesWithOccupyStatus.size(); ++i) {
+      delete m_dfgNodesWithOccupyStatus[i];
+      delete[] m_regs_duration[i];
+      delete[] m_regs_timing[i];
+    }
+    if (m_dfgNodesWithOccupyStatus.size() > 0) {
+      delete[] m_regs_duration;
+      delete[] m_regs_timing;
+    }
+    m_dfgNodesWithOccupyStatus.clear();
+    m_regs_duration = new int*[cycleBoundary];
+    m_regs_timing = new int*[cycleBoundary];
+    for (int i=0; i<cycleBoundary; ++i) {
+      m_dfgNodesWithOccupyStatus.push_back(new list<pair<DFGNode*, int>>());
+      m_regs_duration[i] = new int[m_registerCount];
+      m_regs_timing[i] = new int[m_registerCount];
+    }
+  }
+  m_cycleBoundary = cycleBoundary;
+  m_currentCtrlMemItems = t_cgraNode->m_currentCtrlMemItems;
+  m_registers = t_cgraNode->m_registers;
+  m_multicastArrivals = t_cgraNode->m_multicastArrivals;
+  for (int i=0; i<m_cycleBoundary; ++i) {
+    *(m_dfgNodesWithOccupyStatus[i]) = *(t_cgraNode->m_dfgNodesWithOccupyStatus[i]);
+    for (int j=0; j<m_registerCount; ++j) {
+      m_regs_duration[i][j] = t_cgraNode->m_regs_duration[i][j];
+      m_regs_timing[i][j] = t_cgraNode->m_regs_timing[i][j];
+    }
+  }
+}
+
 bool CGRANode::canSupport(DFGNode* t_opt) {
   if (m_disabled) 
     return false;
@@ -307,17 +351,17 @@ void CGRANode::setDFGNode(DFGNode* t_opt, int t_cycle, int t_II,
   }
   for (int cycle=t_cycle%interval; cycle<m_cycleBoundary; cycle+=interval) {
     if (not t_opt->isMultiCycleExec()) {
-      m_dfgNodesWithOccupyStatus[cycle]->push_back(make_pair(t_opt, SINGLE_OCCUPY));
+      addOccupyStatus(cycle, t_opt, SINGLE_OCCUPY);
     } else {
-      m_dfgNodesWithOccupyStatus[cycle]->push_back(make_pair(t_opt, START_PIPE_OCCUPY));
+      addOccupyStatus(cycle, t_opt, START_PIPE_OCCUPY);
       for (int i=1; i<t_opt->getExecLatency()-1; ++i) {
         if (cycle+i < m_cycleBoundary) {
-          m_dfgNodesWithOccupyStatus[cycle+i]->push_back(make_pair(t_opt, IN_PIPE_OCCUPY));
+          addOccupyStatus(cycle+i, t_opt, IN_PIPE_OCCUPY);
         }
       }
       int lastCycle = cycle+t_opt->getExecLatency()-1;
       if (lastCycle < m_cycleBoundary) {
-        m_dfgNodesWithOccupyStatus[lastCycle]->push_back(make_pair(t_opt, END_PIPE_OCCUPY));
+        addOccupyStatus(lastCycle, t_opt, END_PIPE_OCCUPY);
       }
     }
   }
@@ -327,6 +371,27 @@ void CGRANode::setDFGNode(DFGNode* t_opt, int t_cycle, int t_II,
   t_opt->setMapped();
 }
 
+void CGRANode::addOccupyStatus(int t_cycle, DFGNode* t_opt, int t_status) {
+  if (m_isRecording)
+    m_recordedOccupyCycles.push_back(t_cycle);
+  m_dfgNodesWithOccupyStatus[t_cycle]->push_back(make_pair(t_opt, t_status));
+}
+
+void CGRANode::removeDFGNode(DFGNode* t_opt) {
+  for (int cycle=0; cycle<m_cycleBoundary; ++cycle) {
+    list<pair<DFGNode*, int>>* occupyStatus = m_dfgNodesWithOccupyStatus[cycle];
+    for (list<pair<DFGNode*, int>>::iterator p=occupyStatus->begin();
+        p!=occupyStatus->end();) {
+      if ((*p).first == t_opt)
+        p = occupyStatus->erase(p);
+      else
+        ++p;
+    }
+  }
+  --m_currentCtrlMemItems;
+  t_opt->clearMapped();
+}
+
 DFGNode* CGRANode::getMappedDFGNode(int t_cycle) {
   for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[t_cycle])) {
     if (p.second == SINGLE_OCCUPY or p.second == END_PIPE_OCCUPY) {
@@ -384,6 +449,80 @@ int CGRANode::getAvailableRegisterCount() {
   return (m_registerCount - m_registers.size());
 }
 
+float CGRANode::getRegisterPressure(int t_cycle) {
+  if (m_registerCount == 0 or m_regs_duration == NULL or
+      t_cycle < 0 or t_cycle >= m_cycleBoundary)
+    return 0;
+  int occupied = 0;
+  for (int i=0; i<m_registerCount; ++i)
+    if (m_regs_duration[t_cycle][i] != -1)
+      ++occupied;
+  return float(occupied) / m_registerCount;
+}
+
+void CGRANode::addMulticastArrival(DFGNode* t_dfgNode, int t_cycle,
+    int t_previousID) {
+  map<DFGNode*, pair<int, int>>::iterator arrival =
+      m_multicastArrivals.find(t_dfgNode);
+  if (arrival != m_multicastArrivals.end() and
+      (*arrival).second.first <= t_cycle)
+    return;
+  if (m_isRecording)
+    m_recordedMulticastArrivals.push_back(make_pair(t_dfgNode,
+        arrival == m_multicastArrivals.end() ? make_pair(-1, -1) :
+                                               (*arrival).second));
+  m_multicastArrivals[t_dfgNode] = make_pair(t_cycle, t_previousID);
+}
+
+void CGRANode::recordMRRGChanges() {
+  m_isRecording = true;
+  m_recordedCtrlMemItems = m_currentCtrlMemItems;
+  m_recordedOccupyCycles.clear();
+  m_recordedRegs.clear();
+  m_recordedMulticastArrivals.clear();
+}
+
+void CGRANode::undoMRRGChanges() {
+  // setDFGNode() only appends, so the last appended status goes first.
+  for (list<int>::reverse_iterator iter=m_recordedOccupyCycles.rbegin();
+      iter!=m_recordedOccupyCycles.rend(); ++iter)
+    m_dfgNodesWithOccupyStatus[*iter]->pop_back();
+  // The same register can be changed more than once, restore the oldest
+  // value.
+  for (list<pair<int*, int>>::reverse_iterator iter=m_recordedRegs.rbegin();
+      iter!=m_recordedRegs.rend(); ++iter)
+    *((*iter).first) = (*iter).second;
+  for (list<pair<DFGNode*, pair<int, int>>>::reverse_iterator
+      iter=m_recordedMulticastArrivals.rbegin();
+      iter!=m_recordedMulticastArrivals.rend(); ++iter) {
+    if ((*iter).second.first == -1)
+      m_multicastArrivals.erase((*iter).first);
+    else
+      m_multicastArrivals[(*iter).first] = (*iter).second;
+  }
+  m_currentCtrlMemItems = m_recordedCtrlMemItems;
+  keepMRRGChanges();
+}
+
+void CGRANode::keepMRRGChanges() {
+  m_isRecording = false;
+  m_recordedOccupyCycles.clear();
+  m_recordedRegs.clear();
+  m_recordedMulticastArrivals.clear();
+}
+
+int CGRANode::getMulticastArrival(DFGNode* t_dfgNode) {
+  if (m_multicastArrivals.find(t_dfgNode) == m_multicastArrivals.end())
+    return -1;
+  return m_multicastArrivals[t_dfgNode].first;
+}
+
+int CGRANode::getMulticastPrevious(DFGNode* t_dfgNode) {
+  if (m_multicastArrivals.find(t_dfgNode) == m_multicastArrivals.end())
+    return -1;
+  return m_multicastArrivals[t_dfgNode].second;
+}
+
 CGRALink* CGRANode::getInLink(CGRANode* t_node) {
   for (CGRALink* link: m_inLinks) {
     if (link->getSrc() == t_node) {
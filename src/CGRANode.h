@@ -99,6 +99,10 @@ class CGRANode {
 		 */
     int** m_regs_timing;
 
+		/** The cycle the data of each DFGNode passes this CGRANode at and the ID of the CGRANode it comes from, i.e., the multicast tree that the data of a DFGNode is routed along so far, the other routes of the same data can branch from it.
+		 */
+    map<DFGNode*, pair<int, int>> m_multicastArrivals;
+
 		/**this value record the dfgNodes which has been Occupy and their Occupy status.
 		 * the pair<DFGNode*,int> record the DFGNode which is Occupyed and it's Occupy status (SINGLE OCCUPY,START_PIPE_OCCUPY and so on)
 		 * the list is used to record the Occupyed DFGNode in the same clock cycle.
@@ -106,6 +110,26 @@ class CGRANode {
 		 */
     vector<list<pair<DFGNode*, int>>*> m_dfgNodesWithOccupyStatus;
 
+		/** True means setDFGNode(), allocateReg() and addMulticastArrival() record the old values of what they change, so that undoMRRGChanges() can restore them.
+		 * m_recordedCtrlMemItems : m_currentCtrlMemItems when the recording starts
+		 * m_recordedOccupyCycles : the cycles of m_dfgNodesWithOccupyStatus that setDFGNode() appends to, in the order of the changes
+		 * m_recordedRegs : the changed entries of m_regs_duration and m_regs_timing with their old values, in the order of the changes
+		 * m_recordedMulticastArrivals : the changed entries of m_multicastArrivals with their old values, (-1, -1) if there was none
+		 */
+    bool m_isRecording;
+    int m_recordedCtrlMemItems;
+    list<int> m_recordedOccupyCycles;
+    list<pair<int*, int>> m_recordedRegs;
+    list<pair<DFGNode*, pair<int, int>>> m_recordedMulticastArrivals;
+
+		/** set t_regs[t_cycle][t_reg] to t_portID in allocateReg(), the old value is recorded if m_isRecording.
+		 */
+    void setReg(int** t_regs, int t_cycle, int t_reg, int t_portID);
+
+		/** append the DFGNode with its occupy status to m_dfgNodesWithOccupyStatus[t_cycle] in setDFGNode(), the cycle is recorded if m_isRecording.
+		 */
+    void addOccupyStatus(int t_cycle, DFGNode* t_opt, int t_status);
+
   public:
 		/**The constructor function of class CGRANode
 		 * this function init CGRANode's ID,x and y according the params,other var is init by default value.
@@ -181,6 +205,12 @@ class CGRANode {
 		 * @param t_II : the Value of II
 		 */
 		void constructMRRG(int t_CGRANodeCount, int t_II);
+
+		/**The function to copy the MRRG of another CGRANode with the same ID
+		 * the occupancy of FU, registers and ctrlMem are copied, the DFGNodes are shared.
+		 * @param t_cgraNode : the CGRANode to copy from
+		 */
+		void copyMRRGFrom(CGRANode* t_cgraNode);
     bool canSupport(DFGNode*);
     bool isOccupied(int, int);
     // bool canOccupy(int, int);
@@ -195,11 +225,52 @@ class CGRANode {
 		 * @param t_isStaticElasticCGRA : now is always false
 		 */
 		void setDFGNode(DFGNode* t_opt, int t_cycle, int t_II, bool t_isStaticElasticCGRA);
+
+		/**The function to undo setDFGNode().
+		 * 1. remove t_opt from m_dfgNodesWithOccupyStatus in all the cycles.
+		 * 2. call t_opt's clearMapped method.
+		 * @param t_opt : the DFGNode which is mapped to this CGRANode
+		 */
+		void removeDFGNode(DFGNode* t_opt);
+
+		/**The functions to undo setDFGNode(), allocateReg() and addMulticastArrival() on this CGRANode, e.g., when a schedule fails half way.
+		 * recordMRRGChanges() starts recording the old values of what they change, undoMRRGChanges() restores them and keepMRRGChanges() forgets them, both stop the recording.
+		 * the DFGNodes set by setDFGNode() stay marked as mapped.
+		 */
+    void recordMRRGChanges();
+    void undoMRRGChanges();
+    void keepMRRGChanges();
     void configXbar(CGRALink*, int, int);
     void addRegisterValue(float);
     list<CGRALink*>* getOccupiableInLinks(int, int);
     list<CGRALink*>* getOccupiableOutLinks(int, int);
     int getAvailableRegisterCount();
+
+		/**The function to get the fraction of the registers that are occupied at t_cycle according to m_regs_duration.
+		 * @param t_cycle : the value of cycle
+		 * @return : 0 if there is no register or t_cycle is out of the MRRG, 1 if all of them are occupied
+		 */
+    float getRegisterPressure(int t_cycle);
+
+		/**The function to record that the data of t_dfgNode passes this CGRANode at t_cycle in the multicast tree, only the earliest cycle is kept.
+		 * @param t_dfgNode : the DFGNode that produces the data
+		 * @param t_cycle : the cycle the data is in this CGRANode
+		 * @param t_previousID : the ID of the CGRANode the data comes from
+		 */
+    void addMulticastArrival(DFGNode* t_dfgNode, int t_cycle, int t_previousID);
+
+		/**The function to get the cycle the data of t_dfgNode passes this CGRANode at.
+		 * @param t_dfgNode : the DFGNode that produces the data
+		 * @return : the cycle, -1 if the data is not routed through this CGRANode
+		 */
+    int getMulticastArrival(DFGNode* t_dfgNode);
+
+		/**The function to get the CGRANode the data of t_dfgNode comes from in the multicast tree.
+		 * @param t_dfgNode : the DFGNode that produces the data
+		 * @return : the ID of the previous CGRANode, -1 if the data is not routed through this CGRANode
+		 */
+    int getMulticastPrevious(DFGNode* t_dfgNode);
+
     int getMinIdleCycle(DFGNode*, int, int);
     int getCurrentCtrlMemItems();
     int getX();
@@ -16,6 +16,7 @@
 #include <list>
 #include <stdio.h>
 #include <iostream>
+#include <atomic>
 
 #include "DFGEdge.h"
 
@@ -58,8 +59,9 @@ class DFGNode {
     list<int>* m_cycleID;
 
 		/**this variable is used to record if this DFGNode have been mapped
+		 * it is atomic since the mapping strategies running in parallel share the same DFG
 		 */
-    bool m_isMapped;
+    atomic<bool> m_isMapped;
 
 		/**this variable is used to record how many constants there are in the operands of the current DFG node
 		 */
@@ -16,11 +16,534 @@
 #include <list>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <deque>
 #include <fstream>
+#include <tuple>
 
 //#include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
+#define HEURISTIC_COST_POLICY  0 // HeuristicCostPolicy
+#define CONGESTION_COST_POLICY 1 // CongestionCostPolicy
+#define LATENCY_COST_POLICY    2 // LatencyCostPolicy
+#define REGISTER_COST_POLICY   3 // RegisterCostPolicy
+
+#define LEVEL_MAPPING_ORDER 0 // the order of DFG
+#define SWING_MAPPING_ORDER 1 // getSwingOrder()
+
+Mapper::Mapper() {
+  m_rollbackCandidates = 3;
+  m_imsBudgetRatio = 6;
+  m_pathFinderIterations = 32;
+  m_annealingIterations = 20000;
+  m_annealingTemperature = 5.0;
+  m_annealingCooling = 0.95;
+  m_annealingSeed = 1;
+  m_cancelToken = NULL;
+  m_cancelParent = NULL;
+  m_maxII = -1;
+  m_randomSeed = -1;
+  m_dfsExpansionBudget = 0;
+  m_dfsExpansions = 0;
+  m_dfsTimeBudget = 0;
+  m_dfsPrunings = 0;
+  m_dfsNogoodLearning = false;
+  m_dfsNogoodHits = 0;
+  m_dfsSymmetryBreaking = true;
+  m_dfsSymmetryPrunings = 0;
+  m_dfsThreads = 1;
+  m_dfsDynamicOrdering = false;
+  m_forwardChecking = false;
+  m_dfsForwardCheckRejections = 0;
+  m_parallelIIs = 1;
+  m_windowII = -1;
+  m_recurrenceII = -1;
+  m_recurrenceDFG = NULL;
+  m_aStarRouting = false;
+  m_lazyCandidateEvaluation = false;
+  m_congestionWeight = 2.0;
+  m_linkPressureII = 1;
+  m_isRollbackRecording = false;
+  m_costPolicy = HEURISTIC_COST_POLICY;
+  m_waitingCost = 1.5;
+  m_singleTileCost = 2;
+  m_fanoutPortCost = 4;
+  m_sharedTileBonus = 0.5;
+  m_busyNeighborCost = 0.4;
+  m_memoryTileCost = 2;
+  m_multicastBonus = 0.5;
+  m_freeLinkBonus = 0.3;
+  m_presentFactor = 0.5;
+  m_presentGrowth = 1.6;
+  m_registerHoldCost = 0.2;
+  m_sharedLinkCost = 0.1;
+  m_multicastRouting = false;
+  m_recurrenceFirst = true;
+  m_mappingOrder = LEVEL_MAPPING_ORDER;
+  m_swingSeedStretch = 3;
+  m_warmStart = false;
+  m_beamWidth = 4;
+  m_multiStartCount = 4;
+  m_winningSeed = -1;
+}
+
+void Mapper::setRollbackCandidates(int t_rollbackCandidates) {
+  m_rollbackCandidates = t_rollbackCandidates;
+}
+
+void Mapper::setIMSBudgetRatio(int t_imsBudgetRatio) {
+  m_imsBudgetRatio = t_imsBudgetRatio;
+}
+
+void Mapper::setPathFinderIterations(int t_pathFinderIterations) {
+  m_pathFinderIterations = t_pathFinderIterations;
+}
+
+void Mapper::setAnnealingOptions(int t_iterations, float t_temperature,
+    float t_cooling, int t_seed) {
+  m_annealingIterations = t_iterations;
+  m_annealingTemperature = t_temperature;
+  m_annealingCooling = t_cooling;
+  m_annealingSeed = t_seed;
+}
+
+void Mapper::setRandomSeed(int t_randomSeed) {
+  m_randomSeed = t_randomSeed;
+  if (m_randomSeed != -1)
+    m_random.seed(m_randomSeed);
+}
+
+void Mapper::setDFSExpansionBudget(int t_dfsExpansionBudget) {
+  m_dfsExpansionBudget = t_dfsExpansionBudget;
+}
+
+void Mapper::setDFSTimeBudget(int t_dfsTimeBudget) {
+  m_dfsTimeBudget = t_dfsTimeBudget;
+}
+
+void Mapper::setDFSNogoodLearning(bool t_dfsNogoodLearning) {
+  m_dfsNogoodLearning = t_dfsNogoodLearning;
+}
+
+void Mapper::setDFSSymmetryBreaking(bool t_dfsSymmetryBreaking) {
+  m_dfsSymmetryBreaking = t_dfsSymmetryBreaking;
+}
+
+void Mapper::setDFSThreads(int t_dfsThreads) {
+  m_dfsThreads = t_dfsThreads;
+}
+
+void Mapper::setDFSDynamicOrdering(bool t_dfsDynamicOrdering) {
+  m_dfsDynamicOrdering = t_dfsDynamicOrdering;
+}
+
+void Mapper::setForwardChecking(bool t_forwardChecking) {
+  m_forwardChecking = t_forwardChecking;
+}
+
+void Mapper::setMaxII(int t_maxII) {
+  m_maxII = t_maxII;
+}
+
+void Mapper::setParallelIIs(int t_parallelIIs) {
+  m_parallelIIs = t_parallelIIs;
+}
+
+void Mapper::setAStarRouting(bool t_aStarRouting) {
+  m_aStarRouting = t_aStarRouting;
+}
+
+void Mapper::setLazyCandidateEvaluation(bool t_lazyCandidateEvaluation) {
+  m_lazyCandidateEvaluation = t_lazyCandidateEvaluation;
+}
+
+void Mapper::setCongestionWeight(float t_congestionWeight) {
+  m_congestionWeight = t_congestionWeight;
+}
+
+void Mapper::setCostPolicy(string t_costPolicy) {
+  if (t_costPolicy == "congestion")
+    m_costPolicy = CONGESTION_COST_POLICY;
+  else if (t_costPolicy == "latency")
+    m_costPolicy = LATENCY_COST_POLICY;
+  else if (t_costPolicy == "register")
+    m_costPolicy = REGISTER_COST_POLICY;
+  else
+    m_costPolicy = HEURISTIC_COST_POLICY;
+}
+
+void Mapper::setMappingOrder(string t_mappingOrder) {
+  if (t_mappingOrder == "swing")
+    m_mappingOrder = SWING_MAPPING_ORDER;
+  else
+    m_mappingOrder = LEVEL_MAPPING_ORDER;
+}
+
+void Mapper::setSwingSeedStretch(int t_swingSeedStretch) {
+  m_swingSeedStretch = t_swingSeedStretch;
+}
+
+void Mapper::setCostWeights(map<string, double>* t_costWeights) {
+  for (pair<string, double> weight: *t_costWeights) {
+    // The costs and bonuses are subtracted or added as they are, a
+    // negative one turns them around.
+    if (weight.second < 0)
+      cout<<"[DEBUG] negative cost weight "<<weight.first<<" is ignored\n";
+    else if (weight.first == "waiting")
+      m_waitingCost = weight.second;
+    else if (weight.first == "singleTile")
+      m_singleTileCost = weight.second;
+    else if (weight.first == "fanoutPort")
+      m_fanoutPortCost = weight.second;
+    else if (weight.first == "sharedTile")
+      m_sharedTileBonus = weight.second;
+    else if (weight.first == "busyNeighbor")
+      m_busyNeighborCost = weight.second;
+    else if (weight.first == "memoryTile")
+      m_memoryTileCost = weight.second;
+    else if (weight.first == "multicast")
+      m_multicastBonus = weight.second;
+    else if (weight.first == "freeLink")
+      m_freeLinkBonus = weight.second;
+    else if (weight.first == "presentFactor")
+      m_presentFactor = weight.second;
+    else if (weight.first == "presentGrowth")
+      m_presentGrowth = weight.second;
+    else if (weight.first == "registerHold")
+      m_registerHoldCost = weight.second;
+    else if (weight.first == "sharedLink")
+      m_sharedLinkCost = weight.second;
+    else
+      cout<<"[DEBUG] unknown cost weight "<<weight.first<<" is ignored\n";
+  }
+}
+
+void Mapper::setMulticastRouting(bool t_multicastRouting) {
+  m_multicastRouting = t_multicastRouting;
+}
+
+void Mapper::setRecurrenceFirst(bool t_recurrenceFirst) {
+  m_recurrenceFirst = t_recurrenceFirst;
+}
+
+void Mapper::setWarmStart(bool t_warmStart) {
+  m_warmStart = t_warmStart;
+}
+
+void Mapper::setBeamWidth(int t_beamWidth) {
+  m_beamWidth = t_beamWidth;
+}
+
+void Mapper::setMultiStartCount(int t_multiStartCount) {
+  m_multiStartCount = t_multiStartCount;
+}
+
+int Mapper::getWinningSeed() {
+  return m_winningSeed;
+}
+
+bool Mapper::isCancelled() {
+  return (m_cancelToken != NULL and m_cancelToken->load()) or
+         (m_cancelParent != NULL and m_cancelParent->isCancelled());
+}
+
+bool Mapper::isSearchStopped() {
+  return isCancelled() or
+         (m_dfsExpansionBudget > 0 and m_dfsExpansions > m_dfsExpansionBudget) or
+         (m_dfsTimeBudget > 0 and chrono::steady_clock::now() > m_dfsDeadline);
+}
+
+list<DFGNode*>* Mapper::getMappingOrder(DFG* t_dfg) {
+  if (m_mappingOrder == SWING_MAPPING_ORDER)
+    return getSwingOrder(t_dfg);
+  list<DFGNode*>* mappingOrder = new list<DFGNode*>(t_dfg->nodes);
+  if (m_randomSeed != -1) {
+    // The DFGNodes are ordered by level in DFG, shuffle the DFGNodes within
+    // the same level.
+    mappingOrder->clear();
+    vector<DFGNode*> sameLevel;
+    for (DFGNode* dfgNode: t_dfg->nodes) {
+      if (sameLevel.size() != 0 and
+          sameLevel.back()->getLevel() != dfgNode->getLevel()) {
+        std::shuffle(sameLevel.begin(), sameLevel.end(), m_random);
+        mappingOrder->insert(mappingOrder->end(), sameLevel.begin(),
+                             sameLevel.end());
+        sameLevel.clear();
+      }
+      sameLevel.push_back(dfgNode);
+    }
+    std::shuffle(sameLevel.begin(), sameLevel.end(), m_random);
+    mappingOrder->insert(mappingOrder->end(), sameLevel.begin(),
+                         sameLevel.end());
+  }
+  if (m_recurrenceFirst)
+    placeRecurrencesFirst(t_dfg, mappingOrder);
+  return mappingOrder;
+}
+
+void Mapper::placeRecurrencesFirst(DFG* t_dfg, list<DFGNode*>* t_order) {
+  buildRecurrences(t_dfg);
+  list<list<DFGNode*>*> cycles(t_dfg->getCycleLists()->begin(),
+                               t_dfg->getCycleLists()->end());
+  cycles.sort([](list<DFGNode*>* a, list<DFGNode*>* b) {
+      return a->size() > b->size(); });
+
+  map<DFGNode*, bool> placed;
+  list<DFGNode*> order;
+  for (list<DFGNode*>* cycle: cycles) {
+    map<DFGNode*, bool> group;
+    list<DFGNode*> pending(cycle->begin(), cycle->end());
+    while (pending.size() != 0) {
+      DFGNode* dfgNode = pending.front();
+      pending.pop_front();
+      if (placed[dfgNode] or group[dfgNode])
+        continue;
+      group[dfgNode] = true;
+      for (DFGNode* pred: *(dfgNode->getPredNodes()))
+        if (!isBackEdge(pred, dfgNode))
+          pending.push_back(pred);
+    }
+    for (DFGNode* dfgNode: *t_order) {
+      if (group[dfgNode]) {
+        order.push_back(dfgNode);
+        placed[dfgNode] = true;
+      }
+    }
+  }
+  for (DFGNode* dfgNode: *t_order)
+    if (!placed[dfgNode])
+      order.push_back(dfgNode);
+  t_order->assign(order.begin(), order.end());
+}
+
+list<DFGNode*>* Mapper::getPriorityOrder(DFG* t_dfg) {
+  if (m_mappingOrder == SWING_MAPPING_ORDER)
+    return getSwingOrder(t_dfg);
+  return new list<DFGNode*>(t_dfg->nodes);
+}
+
+list<DFGNode*>* Mapper::getSwingOrder(DFG* t_dfg) {
+  // Only the forward DFGEdges order the DFGNodes.
+  buildRecurrences(t_dfg);
+  map<DFGNode*, list<DFGNode*>> preds;
+  map<DFGNode*, list<DFGNode*>> succs;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    for (DFGNode* succ: *(dfgNode->getSuccNodes())) {
+      if (!isBackEdge(dfgNode, succ)) {
+        succs[dfgNode].push_back(succ);
+        preds[succ].push_back(dfgNode);
+      }
+    }
+  }
+
+  // The depth (ASAP), height and mobility (ALAP - ASAP) of each DFGNode.
+  map<DFGNode*, int> depth;
+  map<DFGNode*, int> height;
+  map<DFGNode*, int> mobility;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    depth[dfgNode] = 0;
+    for (DFGNode* pred: preds[dfgNode])
+      depth[dfgNode] = max(depth[dfgNode], depth[pred] + pred->getExecLatency());
+  }
+  int length = 0;
+  for (list<DFGNode*>::reverse_iterator dfgNode=t_dfg->nodes.rbegin();
+      dfgNode!=t_dfg->nodes.rend(); ++dfgNode) {
+    height[*dfgNode] = 0;
+    for (DFGNode* succ: succs[*dfgNode])
+      height[*dfgNode] = max(height[*dfgNode],
+                             height[succ] + (*dfgNode)->getExecLatency());
+    length = max(length, depth[*dfgNode] + height[*dfgNode]);
+  }
+  for (DFGNode* dfgNode: t_dfg->nodes)
+    mobility[dfgNode] = length - depth[dfgNode] - height[dfgNode];
+  vector<DFGNode*> tieBreaking(t_dfg->nodes.begin(), t_dfg->nodes.end());
+  if (m_randomSeed != -1)
+    std::shuffle(tieBreaking.begin(), tieBreaking.end(), m_random);
+  map<DFGNode*, int> tie;
+  for (int i=0; i<(int)tieBreaking.size(); ++i)
+    tie[tieBreaking[i]] = i;
+
+  // The DFGNodes reachable from (or reaching) t_from along the forward
+  // DFGEdges.
+  auto getReachable = [&](set<DFGNode*>& t_from,
+      map<DFGNode*, list<DFGNode*>>& t_edges) {
+    set<DFGNode*> reachable(t_from.begin(), t_from.end());
+    list<DFGNode*> queue(t_from.begin(), t_from.end());
+    while (queue.size() != 0) {
+      DFGNode* dfgNode = queue.front();
+      queue.pop_front();
+      for (DFGNode* next: t_edges[dfgNode])
+        if (reachable.insert(next).second)
+          queue.push_back(next);
+    }
+    return reachable;
+  };
+
+  // 1. Partition the DFGNodes into sets, the recurrence cycles first.
+  list<list<DFGNode*>*> cycles(t_dfg->getCycleLists()->begin(),
+                               t_dfg->getCycleLists()->end());
+  cycles.sort([](list<DFGNode*>* a, list<DFGNode*>* b) {
+      return a->size() > b->size(); });
+  list<set<DFGNode*>> sets;
+  set<DFGNode*> assigned;
+  for (list<DFGNode*>* cycle: cycles) {
+    set<DFGNode*> current;
+    for (DFGNode* dfgNode: *cycle)
+      if (assigned.find(dfgNode) == assigned.end())
+        current.insert(dfgNode);
+    if (current.size() == 0)
+      continue;
+    // Also take the DFGNodes on the paths within the cycle (they are not
+    // always on the cycle lists) and between it and the former sets.
+    set<DFGNode*> fromAssigned = getReachable(assigned, succs);
+    set<DFGNode*> toAssigned = getReachable(assigned, preds);
+    set<DFGNode*> fromCurrent = getReachable(current, succs);
+    set<DFGNode*> toCurrent = getReachable(current, preds);
+    for (DFGNode* dfgNode: t_dfg->nodes) {
+      if (assigned.find(dfgNode) != assigned.end())
+        continue;
+      if ((fromCurrent.count(dfgNode) and toCurrent.count(dfgNode)) or
+          (fromAssigned.count(dfgNode) and toCurrent.count(dfgNode)) or
+          (fromCurrent.count(dfgNode) and toAssigned.count(dfgNode)))
+        current.insert(dfgNode);
+    }
+    assigned.insert(current.begin(), current.end());
+    sets.push_back(current);
+  }
+  set<DFGNode*> rest;
+  for (DFGNode* dfgNode: t_dfg->nodes)
+    if (assigned.find(dfgNode) == assigned.end())
+      rest.insert(dfgNode);
+  if (rest.size() != 0)
+    sets.push_back(rest);
+
+  // 2. Order each set by sweeping top-down and bottom-up in turn.
+  list<DFGNode*>* order = new list<DFGNode*>();
+  set<DFGNode*> ordered;
+  for (set<DFGNode*>& current: sets) {
+    while (1) {
+      // Start from the predecessors of the ordered DFGNodes (bottom-up),
+      // or their successors (top-down), or the deepest DFGNode left.
+      set<DFGNode*> ready;
+      bool isBottomUp = true;
+      for (DFGNode* dfgNode: current)
+        if (!ordered.count(dfgNode))
+          for (DFGNode* succ: succs[dfgNode])
+            if (ordered.count(succ))
+              ready.insert(dfgNode);
+      if (ready.size() == 0) {
+        isBottomUp = false;
+        for (DFGNode* dfgNode: current)
+          if (!ordered.count(dfgNode))
+            for (DFGNode* pred: preds[dfgNode])
+              if (ordered.count(pred))
+                ready.insert(dfgNode);
+      }
+      if (ready.size() == 0) {
+        isBottomUp = true;
+        DFGNode* deepest = NULL;
+        for (DFGNode* dfgNode: current)
+          if (!ordered.count(dfgNode) and (deepest == NULL or
+              make_tuple(-depth[dfgNode], mobility[dfgNode], tie[dfgNode]) <
+              make_tuple(-depth[deepest], mobility[deepest], tie[deepest])))
+            deepest = dfgNode;
+        if (deepest == NULL)
+          break;
+        ready.insert(deepest);
+      }
+      while (ready.size() != 0) {
+        while (ready.size() != 0) {
+          DFGNode* best = NULL;
+          for (DFGNode* dfgNode: ready) {
+            int priority = isBottomUp ? depth[dfgNode] : height[dfgNode];
+            int bestPriority = best == NULL ? 0 :
+                (isBottomUp ? depth[best] : height[best]);
+            if (best == NULL or
+                make_tuple(-priority, mobility[dfgNode], tie[dfgNode]) <
+                make_tuple(-bestPriority, mobility[best], tie[best]))
+              best = dfgNode;
+          }
+          ready.erase(best);
+          order->push_back(best);
+          ordered.insert(best);
+          for (DFGNode* next: isBottomUp ? preds[best] : succs[best])
+            if (current.count(next) and !ordered.count(next))
+              ready.insert(next);
+        }
+        // Turn around to the DFGNodes on the other side of the ordered ones.
+        isBottomUp = !isBottomUp;
+        for (DFGNode* dfgNode: current)
+          if (!ordered.count(dfgNode))
+            for (DFGNode* next: isBottomUp ? succs[dfgNode] : preds[dfgNode])
+              if (ordered.count(next))
+                ready.insert(dfgNode);
+      }
+    }
+  }
+  return order;
+}
+
+bool Mapper::fitsRecurrences(int t_II, DFGNode* t_dfgNode, int t_cycle) {
+  // Only the DFGEdges into and out of t_dfgNode change, the others keep
+  // their time in m_recurrenceTime, and each DFGEdge with an unmapped end
+  // takes at least one cycle.
+  for (int cycleID: *(t_dfgNode->getCycleIDs())) {
+    vector<DFGNode*>& cycle = m_recurrences[cycleID];
+    int size = cycle.size();
+    int index = m_recurrencePositions[cycleID][t_dfgNode];
+    int totalTime = m_recurrenceTime[cycleID];
+    int mappedEdges = m_recurrenceMappedEdges[cycleID];
+    for (int edge: {(index + size - 1) % size, index}) {
+      int time = getRecurrenceEdgeTime(cycleID, edge);
+      if (time != -1) {
+        totalTime -= time;
+        --mappedEdges;
+      }
+      DFGNode* src = cycle[edge];
+      DFGNode* dst = cycle[(edge + 1) % size];
+      if ((src != t_dfgNode and m_mappingTiming.find(src) == m_mappingTiming.end()) or
+          (dst != t_dfgNode and m_mappingTiming.find(dst) == m_mappingTiming.end()))
+        continue;
+      int t1 = src == t_dfgNode ? t_cycle : m_mappingTiming[src];
+      int t2 = dst == t_dfgNode ? t_cycle : m_mappingTiming[dst];
+      while (t1 >= t2)
+        t2 += t_II;
+      totalTime += t2 - t1;
+      ++mappedEdges;
+      if (size == 1)
+        break;
+    }
+    if (totalTime + size - mappedEdges > t_II)
+      return false;
+  }
+  return true;
+}
+
+void Mapper::copyMappingFrom(Mapper* t_mapper, CGRA* t_cgra) {
+  m_mapping.clear();
+  m_mappingTiming.clear();
+  for (map<DFGNode*, CGRANode*>::iterator iter=t_mapper->m_mapping.begin();
+      iter!=t_mapper->m_mapping.end(); ++iter) {
+    CGRANode* cgraNode = (*iter).second;
+    m_mapping[(*iter).first] = t_cgra->nodes[cgraNode->getY()][cgraNode->getX()];
+  }
+  m_mappingTiming = t_mapper->m_mappingTiming;
+  m_linkPressure = t_mapper->m_linkPressure;
+  m_linkPressureII = t_mapper->m_linkPressureII;
+  m_recurrenceTime = t_mapper->m_recurrenceTime;
+  m_recurrenceMappedEdges = t_mapper->m_recurrenceMappedEdges;
+  m_recurrenceII = t_mapper->m_recurrenceII;
+  m_maxMappingCycle = t_mapper->m_maxMappingCycle;
+  m_asap = t_mapper->m_asap;
+  m_alap = t_mapper->m_alap;
+  m_windowII = t_mapper->m_windowII;
+}
+
 int Mapper::getResMII(DFG* t_dfg, CGRA* t_cgra) {
   int ResMII = ceil(float(t_dfg->getNodeCount()) / t_cgra->getFUCount());
   return ResMII;
@@ -47,18 +570,194 @@ int Mapper::getRecMII(DFG* t_dfg) {
  * 1. clear the mapping
  * 2. call the constructMRRG method of the CGRA class
  * 3. set the maxMappingCycle to a big number. TODO:this may be a misunderstanding.
- * 4. clearMapped for every dfgNode in DFG
+ * 4. compute the scheduling windows if the II changes.
+ * 5. clearMapped for every dfgNode in DFG
  */
 void Mapper::constructMRRG(DFG* t_dfg, CGRA* t_cgra, int t_II) {
   m_mapping.clear();
   m_mappingTiming.clear();
   t_cgra->constructMRRG(t_II);
+  resetLinkPressure(t_cgra, t_II);
   m_maxMappingCycle = t_cgra->getFUCount()*t_II*t_II;
+  if (m_windowII != t_II)
+    computeSchedulingWindows(t_dfg, t_II);
+  initRecurrenceTiming(t_dfg, t_II);
   for (DFGNode* dfgNode: t_dfg->nodes) {
     dfgNode->clearMapped();
   }
 }
 
+void Mapper::initRecurrenceTiming(DFG* t_dfg, int t_II) {
+  buildRecurrences(t_dfg);
+  m_recurrenceII = t_II;
+  m_recurrenceTime.assign(m_recurrences.size(), 0);
+  m_recurrenceMappedEdges.assign(m_recurrences.size(), 0);
+}
+
+void Mapper::buildRecurrences(DFG* t_dfg) {
+  if (m_recurrenceDFG != t_dfg) {
+    m_recurrenceDFG = t_dfg;
+    m_recurrences.clear();
+    m_recurrencePositions.clear();
+    for (list<DFGNode*>* cycle: *(t_dfg->getCycleLists())) {
+      m_recurrences.push_back(vector<DFGNode*>(cycle->begin(), cycle->end()));
+      m_recurrencePositions.push_back(map<DFGNode*, int>());
+      for (int i=0; i<(int)m_recurrences.back().size(); ++i)
+        m_recurrencePositions.back()[m_recurrences.back()[i]] = i;
+    }
+    m_dfgNodePositions.clear();
+    int position = 0;
+    for (DFGNode* dfgNode: t_dfg->nodes)
+      m_dfgNodePositions[dfgNode] = position++;
+  }
+}
+
+bool Mapper::isBackEdge(DFGNode* t_src, DFGNode* t_dst) {
+  return m_dfgNodePositions[t_dst] <= m_dfgNodePositions[t_src];
+}
+
+bool Mapper::isSkippedBackEdge(DFGNode* t_pred, DFGNode* t_dfgNode) {
+  return m_mappingOrder == SWING_MAPPING_ORDER and
+         isBackEdge(t_pred, t_dfgNode);
+}
+
+void Mapper::resetRecurrenceTiming() {
+  for (int cycleID=0; cycleID<(int)m_recurrences.size(); ++cycleID) {
+    m_recurrenceTime[cycleID] = 0;
+    m_recurrenceMappedEdges[cycleID] = 0;
+    for (int i=0; i<(int)m_recurrences[cycleID].size(); ++i) {
+      int time = getRecurrenceEdgeTime(cycleID, i);
+      if (time != -1) {
+        m_recurrenceTime[cycleID] += time;
+        ++m_recurrenceMappedEdges[cycleID];
+      }
+    }
+  }
+}
+
+int Mapper::getRecurrenceEdgeTime(int t_cycleID, int t_index) {
+  vector<DFGNode*>& cycle = m_recurrences[t_cycleID];
+  map<DFGNode*, int>::iterator src = m_mappingTiming.find(cycle[t_index]);
+  map<DFGNode*, int>::iterator dst =
+      m_mappingTiming.find(cycle[(t_index + 1) % cycle.size()]);
+  if (src == m_mappingTiming.end() or dst == m_mappingTiming.end())
+    return -1;
+  int t1 = (*src).second;
+  int t2 = (*dst).second;
+  while (t1 >= t2) {
+    t2 += m_recurrenceII;
+  }
+  return t2 - t1;
+}
+
+void Mapper::setMappingTiming(DFGNode* t_dfgNode, int t_cycle) {
+  // Only the DFGEdges into and out of t_dfgNode change on each cycle, they
+  // are the same DFGEdge on a cycle of one DFGNode.
+  list<int>* cycleIDs = t_dfgNode->getCycleIDs();
+  for (int cycleID: *cycleIDs) {
+    int size = m_recurrences[cycleID].size();
+    int index = m_recurrencePositions[cycleID][t_dfgNode];
+    for (int edge: {(index + size - 1) % size, index}) {
+      int time = getRecurrenceEdgeTime(cycleID, edge);
+      if (time != -1) {
+        m_recurrenceTime[cycleID] -= time;
+        --m_recurrenceMappedEdges[cycleID];
+      }
+      if (size == 1)
+        break;
+    }
+  }
+  m_mappingTiming[t_dfgNode] = t_cycle;
+  for (int cycleID: *cycleIDs) {
+    int size = m_recurrences[cycleID].size();
+    int index = m_recurrencePositions[cycleID][t_dfgNode];
+    for (int edge: {(index + size - 1) % size, index}) {
+      int time = getRecurrenceEdgeTime(cycleID, edge);
+      if (time != -1) {
+        m_recurrenceTime[cycleID] += time;
+        ++m_recurrenceMappedEdges[cycleID];
+      }
+      if (size == 1)
+        break;
+    }
+  }
+}
+
+/**
+ * what is in this function:
+ * 1. ASAP: relax the longest path from the sources, a forward edge delays the
+ *    consumer by the producer's latency, a back edge by the latency minus II.
+ * 2. ALAP: relax the longest path to the sinks in the same way, and subtract
+ *    it from the schedule length, i.e., the critical path with each of its
+ *    cycles stretched by one II for the routing and the modulo conflicts
+ *    (but not beyond the last cycle of the MRRG).
+ * The relaxation stops after one round per DFG node, in case the II is below
+ * the real RecMII.
+ */
+void Mapper::computeSchedulingWindows(DFG* t_dfg, int t_II) {
+  buildRecurrences(t_dfg);
+  map<DFGNode*, int> tail;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    m_asap[dfgNode] = 0;
+    tail[dfgNode] = 0;
+  }
+  bool changed = true;
+  for (int round=0; round<t_dfg->getNodeCount() and changed; ++round) {
+    changed = false;
+    for (DFGNode* dfgNode: t_dfg->nodes) {
+      int delay = dfgNode->getExecLatency() - 1 > 1 ? dfgNode->getExecLatency() - 1 : 1;
+      for (DFGNode* succ: *(dfgNode->getSuccNodes())) {
+        int edgeDelay = delay;
+        if (isBackEdge(dfgNode, succ))
+          edgeDelay -= t_II;
+        if (m_asap[dfgNode] + edgeDelay > m_asap[succ]) {
+          m_asap[succ] = m_asap[dfgNode] + edgeDelay;
+          changed = true;
+        }
+        if (tail[succ] + edgeDelay > tail[dfgNode]) {
+          tail[dfgNode] = tail[succ] + edgeDelay;
+          changed = true;
+        }
+      }
+    }
+  }
+  int length = 0;
+  for (DFGNode* dfgNode: t_dfg->nodes)
+    if (m_asap[dfgNode] + tail[dfgNode] > length)
+      length = m_asap[dfgNode] + tail[dfgNode];
+  int horizon = (length + 1) * (t_II + 1);
+  if (horizon > m_maxMappingCycle - 1)
+    horizon = m_maxMappingCycle - 1;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    m_alap[dfgNode] = horizon - tail[dfgNode];
+    if (m_alap[dfgNode] < m_asap[dfgNode])
+      m_alap[dfgNode] = m_asap[dfgNode];
+  }
+  m_windowII = t_II;
+}
+
+bool Mapper::canBranchFrom(CGRA* t_cgra, DFGNode* t_srcDFGNode,
+    CGRANode* t_srcCGRANode, CGRANode* t_cgraNode, CGRANode* t_dstCGRANode,
+    int t_srcTiming) {
+  if (t_cgraNode == t_srcCGRANode or t_cgraNode == t_dstCGRANode or
+      t_cgraNode->getMulticastArrival(t_srcDFGNode) < t_srcTiming)
+    return false;
+  // The route follows the tree back to t_srcCGRANode, it cannot pass the
+  // dst CGRANode twice.
+  CGRANode* treeNode = t_cgraNode;
+  for (int hops=0; hops<t_cgra->getFUCount(); ++hops) {
+    if (treeNode == t_dstCGRANode)
+      return false;
+    int previousID = treeNode->getMulticastPrevious(t_srcDFGNode);
+    if (previousID == -1)
+      return false;
+    treeNode = t_cgra->getNode(previousID);
+    if (treeNode == t_srcCGRANode)
+      return true;
+  }
+  return false;
+}
+
 // The arriving data can stay inside the input buffer
 map<CGRANode*, int>* Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
     int t_II, DFGNode* t_srcDFGNode, DFGNode* t_targetDFGNode,
@@ -80,16 +779,41 @@ map<CGRANode*, int>* Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
     }
   }
   distance[m_mapping[t_srcDFGNode]] = 0;
+  // Branch from the multicast tree of the data as in tryToRoute().
+  int srcTiming = timing[srcCGRANode];
+  if (m_multicastRouting) {
+    for (int i=0; i<t_cgra->getRows(); ++i) {
+      for (int j=0; j<t_cgra->getColumns(); ++j) {
+        CGRANode* node = t_cgra->nodes[i][j];
+        if (!canBranchFrom(t_cgra, t_srcDFGNode, srcCGRANode, node,
+            t_dstCGRANode, srcTiming))
+          continue;
+        distance[node] = node->getMulticastArrival(t_srcDFGNode) - srcTiming;
+        timing[node] = node->getMulticastArrival(t_srcDFGNode);
+      }
+    }
+  }
+  // A* search: every hop takes at least one cycle, so the hop distance to
+  // the target never overestimates the remaining cost.
   while (searchPool.size() != 0) {
+    if (isCancelled())
+      return NULL;
     int minCost = m_maxMappingCycle + 1;
-    CGRANode* minNode;
+    CGRANode* minNode = NULL;
     for (CGRANode* currentNode: searchPool) {
-      if (distance[currentNode] < minCost) {
-        minCost = distance[currentNode];
+      if (distance[currentNode] >= m_maxMappingCycle)
+        continue;
+      int estimate = distance[currentNode];
+      if (m_aStarRouting)
+        estimate += t_cgra->getHopDistance(currentNode, t_dstCGRANode);
+      if (estimate < minCost) {
+        minCost = estimate;
         minNode = currentNode;
       }
     }
-    assert(minNode != NULL);
+    // The rest of the CGRA nodes are not reachable.
+    if (minNode == NULL)
+      break;
     searchPool.remove(minNode);
     // found the target point in the shortest path
     if (minNode == t_dstCGRANode) {
@@ -99,6 +823,10 @@ map<CGRANode*, int>* Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
     list<CGRANode*>* currentNeighbors = minNode->getNeighbors();
 //    cout<<"DEBUG no need?"<<endl;
 
+    // The link occupancy repeats every II cycles, and the data arriving
+    // after the target's ALAP is useless. The data only passes the
+    // CGRANodes of the multicast tree, it cannot wait there.
+    bool isTreeNode = previous[minNode] == NULL and minNode != srcCGRANode;
     for (CGRANode* neighbor: *currentNeighbors) {
       int cycle = timing[minNode];
       while (1) {
@@ -115,7 +843,8 @@ map<CGRANode*, int>* Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
           break;
         }
         ++cycle;
-        if(cycle > m_maxMappingCycle)
+        if(cycle > m_maxMappingCycle or cycle >= timing[minNode] + t_II or
+           cycle >= m_alap[t_targetDFGNode] or isTreeNode)
           break;
       }
     }
@@ -125,12 +854,22 @@ map<CGRANode*, int>* Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
   map<CGRANode*, int>* path = new map<CGRANode*, int>();
   CGRANode* u = t_dstCGRANode;
   if (previous[u] != NULL or u == m_mapping[t_srcDFGNode]) {
+    CGRANode* first = u;
     while (u != NULL) {
       (*path)[u] = timing[u];
+      first = u;
       u = previous[u];
     }
+    // The path branches from the multicast tree, follow the tree back to
+    // the srcCGRANode.
+    while (first != srcCGRANode) {
+      first = t_cgra->getNode(first->getMulticastPrevious(t_srcDFGNode));
+      (*path)[first] = first == srcCGRANode ? timing[srcCGRANode] :
+          first->getMulticastArrival(t_srcDFGNode);
+    }
   }
   if (timing[t_dstCGRANode] > m_maxMappingCycle or
+      timing[t_dstCGRANode] > m_alap[t_targetDFGNode] or
       !t_dstCGRANode->canOccupy(t_targetDFGNode,
       timing[t_dstCGRANode], t_II)) {
 //    path.clear();
@@ -150,144 +889,366 @@ list<map<CGRANode*, int>*>* Mapper::getOrderedPotentialPaths(CGRA* t_cgra,
     DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths) {
   map<map<CGRANode*, int>*, float>* pathsWithCost =
       new map<map<CGRANode*, int>*, float>();
+  // Pick the policy once, the loop over the paths is instantiated for it.
+  if (m_costPolicy == CONGESTION_COST_POLICY)
+    getPathCosts<CongestionCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode,
+                                       t_paths, pathsWithCost);
+  else if (m_costPolicy == LATENCY_COST_POLICY)
+    getPathCosts<LatencyCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode,
+                                    t_paths, pathsWithCost);
+  else if (m_costPolicy == REGISTER_COST_POLICY)
+    getPathCosts<RegisterCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode,
+                                     t_paths, pathsWithCost);
+  else
+    getPathCosts<HeuristicCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode,
+                                      t_paths, pathsWithCost);
+
+  // The paths with the same cost keep their order in t_paths, rather than
+  // the order of their addresses, or a random order if m_randomSeed is
+  // not -1. The costs themselves are not changed.
+  list<map<CGRANode*, int>*>* potentialPaths = new list<map<CGRANode*, int>*>();
+  list<map<CGRANode*, int>*> remainingPaths;
+  map<map<CGRANode*, int>*, unsigned> tieBreaking;
+  for (map<CGRANode*, int>* path: *t_paths) {
+    if (pathsWithCost->find(path) != pathsWithCost->end()) {
+      tieBreaking[path] = m_randomSeed != -1 ? m_random() :
+                                               remainingPaths.size();
+      remainingPaths.push_back(path);
+    }
+  }
+  while(remainingPaths.size() != 0) {
+    float minCost = (*pathsWithCost)[remainingPaths.front()];
+    map<CGRANode*, int>* currentPath = remainingPaths.front();
+    for (map<CGRANode*, int>* path: remainingPaths) {
+      if ((*pathsWithCost)[path] < minCost or
+          ((*pathsWithCost)[path] == minCost and
+           tieBreaking[path] < tieBreaking[currentPath])) {
+        minCost = (*pathsWithCost)[path];
+        currentPath = path;
+      }
+    }
+    remainingPaths.remove(currentPath);
+    potentialPaths->push_back(currentPath);
+  }
+
+  delete pathsWithCost;
+  return potentialPaths;
+}
+
+template <class CostPolicy>
+void Mapper::getPathCosts(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths,
+    map<map<CGRANode*, int>*, float>* t_pathsWithCost) {
   for (list<map<CGRANode*, int>*>::iterator path=t_paths->begin();
       path!=t_paths->end(); ++path) {
     if ((*path)->size() == 0)
       continue;
+    map<CGRANode*, int>::iterator cycleItr = (*path)->begin();
+    int distanceCost = 0;
+    for (; cycleItr!=(*path)->end(); ++cycleItr)
+      if ((*cycleItr).second > distanceCost)
+        distanceCost = (*cycleItr).second;
+    if (distanceCost >= m_maxMappingCycle)
+      continue;
+    float cost = getPathCost<CostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode, *path);
+    (*t_pathsWithCost)[*path] = cost;
+  }
+}
+
+float Mapper::getPathCost(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, map<CGRANode*, int>* t_path) {
+  if (m_costPolicy == CONGESTION_COST_POLICY)
+    return getPathCost<CongestionCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode, t_path);
+  else if (m_costPolicy == LATENCY_COST_POLICY)
+    return getPathCost<LatencyCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode, t_path);
+  else if (m_costPolicy == REGISTER_COST_POLICY)
+    return getPathCost<RegisterCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode, t_path);
+  return getPathCost<HeuristicCostPolicy>(t_cgra, t_dfg, t_II, t_dfgNode, t_path);
+}
 
+/**
+ * what is in this function:
+ * 1. the cost starts from the cycle the path reaches the target CGRANode,
+ *    weighted by the distanceWeight of the CostPolicy.
+ * 2. add the penalties and bonuses of the target CGRANode and the links along the path.
+ * 3. add the congestion or register terms if the CostPolicy asks for them.
+ */
+template <class CostPolicy>
+float Mapper::getPathCost(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, map<CGRANode*, int>* t_path) {
 		//this step is not necessory.just convert the map<CGRANode*,int> to map<int,CGRANode*>
-    map<int, CGRANode*>* reorderPath = getReorderPath(*path);
+  map<int, CGRANode*>* reorderPath = getReorderPath(t_path);
 
-    map<int, CGRANode*>::reverse_iterator riter=reorderPath->rbegin();//建立一个反向迭代器
+  map<int, CGRANode*>::reverse_iterator riter=reorderPath->rbegin();//建立一个反向迭代器
 
-    int distanceCost = (*riter).first;//将最大的时钟周期作为距离代价
-    CGRANode* targetCGRANode = (*riter).second;
-    int targetCycle = (*riter).first;
-    if (distanceCost >= m_maxMappingCycle)
-      continue;
-    float cost = distanceCost + 1;
+  int distanceCost = (*riter).first;//将最大的时钟周期作为距离代价
+  CGRANode* targetCGRANode = (*riter).second;
+  int targetCycle = (*riter).first;
+  float cost = (distanceCost + 1) * CostPolicy::distanceWeight;
 
-    // Consider the same tile mapped with continuously two DFG nodes.
-    map<int, CGRANode*>::iterator lastCGRANodeItr=reorderPath->begin();
-    for (map<int, CGRANode*>::iterator cgraNodeItr=reorderPath->begin();
-        cgraNodeItr!=reorderPath->end(); ++cgraNodeItr) {
-      if (cgraNodeItr != reorderPath->begin()) {
-        int lastCycle = (*lastCGRANodeItr).first;
-        int currentCycle = (*cgraNodeItr).first;
-        int delta = currentCycle - lastCycle;
-        if (delta > 1) {
-          cost = cost + 1.5;
+  // Consider the same tile mapped with continuously two DFG nodes.
+  map<int, CGRANode*>::iterator lastCGRANodeItr=reorderPath->begin();
+  for (map<int, CGRANode*>::iterator cgraNodeItr=reorderPath->begin();
+      cgraNodeItr!=reorderPath->end(); ++cgraNodeItr) {
+    if (cgraNodeItr != reorderPath->begin()) {
+      int lastCycle = (*lastCGRANodeItr).first;
+      int currentCycle = (*cgraNodeItr).first;
+      int delta = currentCycle - lastCycle;
+      if (delta > 1) {
+        cost = cost + m_waitingCost;
+        // The data waits in a register of the CGRA node in between.
+        if (CostPolicy::registerAware) {
+          CGRANode* waitingCGRANode = (*lastCGRANodeItr).second;
+          for (int cycle=lastCycle+1; cycle<currentCycle; ++cycle)
+            cost += waitingCGRANode->getRegisterPressure(cycle);
         }
       }
-      lastCGRANodeItr = cgraNodeItr;
-    }
-
-    // Consider the single tile that processes everything. FIXME: this is
-    // actually a bug because we use map<CGRANode*, int> rather than
-    // map<int, CGRANode*>, in which case the different cycles's execution
-    // will be wrongly merged into one.
-    if (reorderPath->size() == 1) {
-      cost += 2;
     }
+    lastCGRANodeItr = cgraNodeItr;
+  }
 
-    // Consider the cost of the utilization of contrl memory.
-    cost += targetCGRANode->getCurrentCtrlMemItems()/2;
+  // Consider the single tile that processes everything. FIXME: this is
+  // actually a bug because we use map<CGRANode*, int> rather than
+  // map<int, CGRANode*>, in which case the different cycles's execution
+  // will be wrongly merged into one.
+  if (reorderPath->size() == 1) {
+    cost += m_singleTileCost;
+  }
 
-    // Consider the cost of the outgoing ports.
-    if (t_dfgNode->getSuccNodes()->size() > 1) {
-      cost += 4 - targetCGRANode->getOutLinks()->size() +
-          abs(t_cgra->getColumns()/2-targetCGRANode->getX()) +
-          abs(t_cgra->getRows()/2-targetCGRANode->getX());
-    }
-    if (t_dfgNode->getPredNodes()->size() > 0) {
-      list<DFGNode*>* tempPredNodes = t_dfgNode->getPredNodes();
-      for (DFGNode* predDFGNode: *tempPredNodes) {
-        if (predDFGNode->getSuccNodes()->size() > 2
-            and m_mapping.find(predDFGNode) != m_mapping.end()) {
-          if (m_mapping[predDFGNode] == targetCGRANode)
-            cost -= 0.5;
-        }
-      }
-    }
+  // Consider the penalties and bonuses that only depend on the target
+  // CGRA node.
+  cost += getTileCost<CostPolicy>(t_cgra, t_dfg, t_dfgNode, targetCGRANode);
 
-    // Consider the cost of that the DFG node with multiple successor
-    // might potentially occupy the surrounding CGRA nodes.
-    list<CGRANode*>* neighbors = targetCGRANode->getNeighbors();
-    for (CGRANode* neighbor: *neighbors) {
-      list<DFGNode*>* dfgNodes = getMappedDFGNodes(t_dfg, neighbor);
-      for (DFGNode* dfgNode: *dfgNodes) {
-        if (dfgNode->getSuccNodes()->size() > 2) {
-          cost += 0.4;
-        }
+  // Consider the bonus of reusing the same link for delivery the
+  // same data to different destination CGRA nodes (multicast).
+  lastCGRANodeItr=reorderPath->begin();
+  for (map<int, CGRANode*>::iterator cgraNodeItr=reorderPath->begin();
+      cgraNodeItr!=reorderPath->end(); ++cgraNodeItr) {
+    if (cgraNodeItr != reorderPath->begin()) {
+      CGRANode* left = (*lastCGRANodeItr).second;
+      CGRANode* right = (*cgraNodeItr).second;
+      int leftCycle = (*lastCGRANodeItr).first;
+//        cout<<"$$$$$$$$$$ wrong?! left node: "<<left->getID()<<" -> right node: "<<right->getID()<<endl;
+      CGRALink* l = left->getOutLink(right);
+      if (l != NULL and l->isReused(leftCycle)) {
+        cost -= m_multicastBonus;
       }
     }
+    lastCGRANodeItr = cgraNodeItr;
+  }
 
-    // Consider the cost of occupying the leftmost (rightmost) CGRA
-    // nodes that are reserved for load.
-    if ((!t_dfgNode->isLoad() and targetCGRANode->canLoad()) or
-        (!t_dfgNode->isStore() and targetCGRANode->canStore())) {
-      cost += 2;
-    }
-
-    // Consider the bonus of reusing the same link for delivery the
-    // same data to different destination CGRA nodes (multicast).
+  // Consider the congestion of the links along the path.
+  if (CostPolicy::congestionAware) {
     lastCGRANodeItr=reorderPath->begin();
     for (map<int, CGRANode*>::iterator cgraNodeItr=reorderPath->begin();
         cgraNodeItr!=reorderPath->end(); ++cgraNodeItr) {
       if (cgraNodeItr != reorderPath->begin()) {
-        CGRANode* left = (*lastCGRANodeItr).second;
-        CGRANode* right = (*cgraNodeItr).second;
-        int leftCycle = (*lastCGRANodeItr).first;
-//        cout<<"$$$$$$$$$$ wrong?! left node: "<<left->getID()<<" -> right node: "<<right->getID()<<endl;
-        CGRALink* l = left->getOutLink(right);
-        if (l != NULL and l->isReused(leftCycle)) {
-          cost -= 0.5;
-        }
+        CGRALink* l = (*lastCGRANodeItr).second->getOutLink((*cgraNodeItr).second);
+        if (l != NULL)
+          cost += m_congestionWeight * getLinkPressure(l);
       }
       lastCGRANodeItr = cgraNodeItr;
     }
+  }
+
+  // Consider the bonus of available links on the target CGRA nodes.
+  cost -= targetCGRANode->getOccupiableInLinks(targetCycle, t_II)->size()*m_freeLinkBonus +
+      targetCGRANode->getOccupiableOutLinks(targetCycle, t_II)->size()*m_freeLinkBonus;
+
+  delete reorderPath;
+  return cost;
+}
 
-    // Consider the bonus of available links on the target CGRA nodes.
-    cost -= targetCGRANode->getOccupiableInLinks(targetCycle, t_II)->size()*0.3 +
-        targetCGRANode->getOccupiableOutLinks(targetCycle, t_II)->size()*0.3;
+/**
+ * what is in this function:
+ * the penalties and bonuses of the target CGRANode in getPathCost(), they
+ * do not depend on the routing, so they are also part of the lower bound.
+ */
+template <class CostPolicy>
+float Mapper::getTileCost(CGRA* t_cgra, DFG* t_dfg, DFGNode* t_dfgNode,
+    CGRANode* t_fu) {
+  float cost = 0;
+  // Consider the cost of the utilization of contrl memory.
+  cost += t_fu->getCurrentCtrlMemItems()/2;
 
-    (*pathsWithCost)[*path] = cost;
+  // Consider the cost of the outgoing ports.
+  if (t_dfgNode->getSuccNodes()->size() > 1) {
+    cost += m_fanoutPortCost - t_fu->getOutLinks()->size() +
+        t_cgra->getHopDistance(t_fu,
+            t_cgra->nodes[t_cgra->getRows()/2][t_cgra->getColumns()/2]);
+  }
+  if (t_dfgNode->getPredNodes()->size() > 0) {
+    list<DFGNode*>* tempPredNodes = t_dfgNode->getPredNodes();
+    for (DFGNode* predDFGNode: *tempPredNodes) {
+      if (predDFGNode->getSuccNodes()->size() > 2
+          and m_mapping.find(predDFGNode) != m_mapping.end()) {
+        if (m_mapping[predDFGNode] == t_fu)
+          cost -= m_sharedTileBonus;
+      }
+    }
   }
 
-  list<map<CGRANode*, int>*>* potentialPaths = new list<map<CGRANode*, int>*>();
-  while(pathsWithCost->size() != 0) {
-    float minCost = (*pathsWithCost->begin()).second;
-    map<CGRANode*, int>* currentPath = (*pathsWithCost->begin()).first;
-    for (map<map<CGRANode*, int>*, float>::iterator pathItr=pathsWithCost->begin();
-        pathItr!=pathsWithCost->end(); ++pathItr) {
-      if ((*pathItr).second < minCost) {
-        minCost = (*pathItr).second;
-        currentPath = (*pathItr).first;
+  // Consider the cost of that the DFG node with multiple successor
+  // might potentially occupy the surrounding CGRA nodes.
+  list<CGRANode*>* neighbors = t_fu->getNeighbors();
+  for (CGRANode* neighbor: *neighbors) {
+    list<DFGNode*>* dfgNodes = getMappedDFGNodes(t_dfg, neighbor);
+    for (DFGNode* dfgNode: *dfgNodes) {
+      if (dfgNode->getSuccNodes()->size() > 2) {
+        cost += m_busyNeighborCost;
       }
     }
-    pathsWithCost->erase(currentPath);
-    potentialPaths->push_back(currentPath);
   }
 
-  delete pathsWithCost;
-  return potentialPaths;
+  // Consider the cost of occupying the leftmost (rightmost) CGRA
+  // nodes that are reserved for load.
+  if ((!t_dfgNode->isLoad() and t_fu->canLoad()) or
+      (!t_dfgNode->isStore() and t_fu->canStore())) {
+    cost += m_memoryTileCost;
+  }
+
+  // Consider the congestion around the target CGRA node, the data from
+  // and to the DFG node needs some of these link slots, so the most
+  // contended one makes the tile a hot spot.
+  if (CostPolicy::congestionAware and m_congestionWeight != 0) {
+    float maxPressure = 0;
+    for (CGRALink* link: *(t_fu->getInLinks()))
+      if (getLinkPressure(link) > maxPressure)
+        maxPressure = getLinkPressure(link);
+    for (CGRALink* link: *(t_fu->getOutLinks()))
+      if (getLinkPressure(link) > maxPressure)
+        maxPressure = getLinkPressure(link);
+    cost += m_congestionWeight * maxPressure;
+  }
+  return cost;
 }
 
-map<CGRANode*, int>* Mapper::getPathWithMinCostAndConstraints(CGRA* t_cgra,
-    DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths) {
+bool Mapper::isCongestionAware() {
+  return m_costPolicy == CONGESTION_COST_POLICY and m_congestionWeight != 0;
+}
 
-  list<map<CGRANode*, int>*>* potentialPaths =
-      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, t_dfgNode, t_paths);
+void Mapper::resetLinkPressure(CGRA* t_cgra, int t_II) {
+  m_linkPressure.assign(isCongestionAware() ? t_cgra->getLinkCount() : 0, 0);
+  m_linkPressureII = t_II;
+}
 
-  // The paths are already ordered well based on the cost in getPotentialPaths().
-  list<map<CGRANode*, int>*>::iterator pathItr=potentialPaths->begin();
-  return (*pathItr);
+void Mapper::addLinkPressure(CGRALink* t_link, int t_cycle) {
+  // Each occupied modulo slot counts once, the multicast routes share it.
+  if (isCongestionAware() and !t_link->isOccupied(t_cycle))
+    m_linkPressure[t_link->getID()] += 1;
 }
 
-list<DFGNode*>* Mapper::getMappedDFGNodes(DFG* t_dfg, CGRANode* t_cgraNode) {
-  list<DFGNode*>* dfgNodes = new list<DFGNode*>();
-  for (DFGNode* dfgNode: t_dfg->nodes) {
-    if (m_mapping.find(dfgNode) != m_mapping.end())
+void Mapper::spreadRouteDemand(CGRANode* t_cgraNode, float t_routes) {
+  list<CGRALink*> outLinks;
+  for (CGRALink* link: *(t_cgraNode->getOutLinks()))
+    if (!link->isDisabled())
+      outLinks.push_back(link);
+  for (CGRALink* link: outLinks)
+    m_linkPressure[link->getID()] += t_routes / outLinks.size();
+}
+
+/**
+ * what is in this function:
+ * 1. t_dfgNode needs one route for each unmapped successor, the demand moves from its former CGRANode (if any) to t_fu.
+ * 2. if t_dfgNode is mapped for the first time, each mapped predecessor has one route less to come.
+ * 3. map t_dfgNode onto t_fu.
+ */
+void Mapper::setMapping(DFGNode* t_dfgNode, CGRANode* t_fu) {
+  map<DFGNode*, CGRANode*>::iterator former = m_mapping.find(t_dfgNode);
+  if (isCongestionAware()) {
+    int routes = 0;
+    for (DFGNode* succ: *(t_dfgNode->getSuccNodes()))
+      if (succ != t_dfgNode and m_mapping.find(succ) == m_mapping.end())
+        ++routes;
+    if (former != m_mapping.end()) {
+      spreadRouteDemand((*former).second, -routes);
+    } else {
+      for (DFGNode* pred: *(t_dfgNode->getPredNodes()))
+        if (pred != t_dfgNode and m_mapping.find(pred) != m_mapping.end())
+          spreadRouteDemand(m_mapping[pred], -1);
+    }
+    spreadRouteDemand(t_fu, routes);
+  }
+  m_mapping[t_dfgNode] = t_fu;
+}
+
+float Mapper::getLinkPressure(CGRALink* t_link) {
+  if (t_link->getID() >= (int)m_linkPressure.size())
+    return 0;
+  return m_linkPressure[t_link->getID()] / m_linkPressureII;
+}
+
+/**
+ * what is in this function:
+ * 1. the target CGRANode cannot be reached before the latest mapped
+ *    predecessor finishes plus the hop distance from its CGRANode.
+ * 2. the multicast bonus is at most m_multicastBonus per cycle of the path,
+ *    and the bonus of the available links is at most m_freeLinkBonus per
+ *    link of the target.
+ * 3. the rest of getPathCost() is either exact (getTileCost) or not negative.
+ */
+float Mapper::getCostLowerBound(CGRA* t_cgra, DFG* t_dfg,
+    DFGNode* t_dfgNode, CGRANode* t_fu) {
+  if (m_costPolicy == CONGESTION_COST_POLICY)
+    return getCostLowerBound<CongestionCostPolicy>(t_cgra, t_dfg, t_dfgNode, t_fu);
+  else if (m_costPolicy == LATENCY_COST_POLICY)
+    return getCostLowerBound<LatencyCostPolicy>(t_cgra, t_dfg, t_dfgNode, t_fu);
+  else if (m_costPolicy == REGISTER_COST_POLICY)
+    return getCostLowerBound<RegisterCostPolicy>(t_cgra, t_dfg, t_dfgNode, t_fu);
+  return getCostLowerBound<HeuristicCostPolicy>(t_cgra, t_dfg, t_dfgNode, t_fu);
+}
+
+template <class CostPolicy>
+float Mapper::getCostLowerBound(CGRA* t_cgra, DFG* t_dfg,
+    DFGNode* t_dfgNode, CGRANode* t_fu) {
+  int arrival = 0;
+  int departure = m_maxMappingCycle;
+  for (DFGNode* pred: *(t_dfgNode->getPredNodes())) {
+    if (m_mapping.find(pred) == m_mapping.end() or
+        isSkippedBackEdge(pred, t_dfgNode))
+      continue;
+    int ready = m_mappingTiming[pred] + pred->getExecLatency() - 1;
+    if (ready + t_cgra->getHopDistance(m_mapping[pred], t_fu) > arrival)
+      arrival = ready + t_cgra->getHopDistance(m_mapping[pred], t_fu);
+    if (ready < departure)
+      departure = ready;
+  }
+  if (departure > arrival)
+    departure = arrival;
+  float cost = (arrival + 1) * CostPolicy::distanceWeight -
+      m_multicastBonus * (arrival - departure);
+  cost += getTileCost<CostPolicy>(t_cgra, t_dfg, t_dfgNode, t_fu);
+  cost -= (t_fu->getInLinks()->size() + t_fu->getOutLinks()->size()) *
+      m_freeLinkBonus;
+  return cost;
+}
+
+bool Mapper::isCostLowerBoundAdmissible() {
+  float distanceWeight = HeuristicCostPolicy::distanceWeight;
+  if (m_costPolicy == CONGESTION_COST_POLICY)
+    distanceWeight = CongestionCostPolicy::distanceWeight;
+  else if (m_costPolicy == LATENCY_COST_POLICY)
+    distanceWeight = LatencyCostPolicy::distanceWeight;
+  else if (m_costPolicy == REGISTER_COST_POLICY)
+    distanceWeight = RegisterCostPolicy::distanceWeight;
+  return m_multicastBonus <= distanceWeight;
+}
+
+map<CGRANode*, int>* Mapper::getPathWithMinCostAndConstraints(CGRA* t_cgra,
+    DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths) {
+
+  list<map<CGRANode*, int>*>* potentialPaths =
+      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, t_dfgNode, t_paths);
+
+  // The paths are already ordered well based on the cost in getPotentialPaths().
+  list<map<CGRANode*, int>*>::iterator pathItr=potentialPaths->begin();
+  return (*pathItr);
+}
+
+list<DFGNode*>* Mapper::getMappedDFGNodes(DFG* t_dfg, CGRANode* t_cgraNode) {
+  list<DFGNode*>* dfgNodes = new list<DFGNode*>();
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    if (m_mapping.find(dfgNode) != m_mapping.end())
       if ( m_mapping[dfgNode] == t_cgraNode)
         dfgNodes->push_back(dfgNode);
   }
@@ -313,6 +1274,8 @@ map<CGRANode*, int>* Mapper::calculateCost(CGRA* t_cgra, DFG* t_dfg,
   bool isAnyPredDFGNodeMapped = false;//对第一个DFGNode进行处理
   // 2. Traverse each predNodes,check if any predNodes has been mapped,if true, try to map t_dfgNode to t_fu, use dijkstra_search to find a path, if the path is legal, return the path.else return NULL.
   for(DFGNode* pre: *predNodes) {//对所有之前的dfgNode进行遍历，……
+    if (isSkippedBackEdge(pre, t_dfgNode))
+      continue;
     if(m_mapping.find(pre) != m_mapping.end()) {//m_mapping 是一个DFGNode到CGRANode的映射
       map<CGRANode*, int>* tempPath = NULL;
       if (t_fu->canSupport(t_dfgNode))
@@ -335,18 +1298,68 @@ map<CGRANode*, int>* Mapper::calculateCost(CGRA* t_cgra, DFG* t_dfg,
   // TODO  A DFG node can be mapped onto any CGRA node if no predecessor
   //       of it has been mapped.
   // TODO: should also consider the current config mem iterms.
+  // The FU occupancy repeats every II cycles, so only the first II cycles
+  // of the window are worth trying.
+  // In the swing order, the successors mapped first (the bottom-up part)
+  // need the data one cycle per hop before they start.
+  int deadline = m_maxMappingCycle;
+  for (DFGNode* succ: *(t_dfgNode->getSuccNodes())) {
+    if (m_mappingOrder != SWING_MAPPING_ORDER or
+        m_mapping.find(succ) == m_mapping.end() or
+        isBackEdge(t_dfgNode, succ))
+      continue;
+    int hops = t_cgra->getHopDistance(t_fu, m_mapping[succ]);
+    int latest = m_mappingTiming[succ] - (hops > 0 ? hops : 1) -
+                 (t_dfgNode->getExecLatency() - 1);
+    if (latest < deadline)
+      deadline = latest;
+  }
+  if (!isAnyPredDFGNodeMapped and deadline < m_maxMappingCycle) {
+    // Place it as late as the successors allow.
+    if (!t_fu->canSupport(t_dfgNode))
+      return NULL;
+    int cycle = deadline < m_alap[t_dfgNode] ? deadline : m_alap[t_dfgNode];
+    while (cycle >= m_asap[t_dfgNode] and cycle > deadline - t_II) {
+      if (t_fu->canOccupy(t_dfgNode, cycle, t_II) and
+          (!m_recurrenceFirst or !t_dfgNode->isCritical() or
+           fitsRecurrences(t_II, t_dfgNode, cycle))) {
+        path = new map<CGRANode*, int>();
+        (*path)[t_fu] = cycle;
+        return path;
+      }
+      --cycle;
+    }
+    return NULL;
+  }
   if (!isAnyPredDFGNodeMapped) {
     if (!t_fu->canSupport(t_dfgNode))
       return NULL;
-    int cycle = 0;
-    while (cycle < m_maxMappingCycle) {
-      if (t_fu->canOccupy(t_dfgNode, cycle, t_II)) {
+    // In the swing order, the predecessors of a DFGNode mapped without any
+    // mapped neighbor come later, leave them the room to route to it.
+    int start = m_asap[t_dfgNode];
+    if (m_mappingOrder == SWING_MAPPING_ORDER)
+      start *= m_swingSeedStretch;
+    int cycle = start;
+    while (cycle < m_maxMappingCycle and cycle < start + t_II and
+           cycle <= m_alap[t_dfgNode]) {
+      if (t_fu->canOccupy(t_dfgNode, cycle, t_II) and
+          (!m_recurrenceFirst or !t_dfgNode->isCritical() or
+           fitsRecurrences(t_II, t_dfgNode, cycle))) {
         path = new map<CGRANode*, int>();
         (*path)[t_fu] = cycle;
         return path;
       }
       ++cycle;
     }
+  } else if ((*path)[t_fu] > deadline) {
+    cout<<"[DEBUG] DFG node "<<t_dfgNode->getID()<<" on CGRA node "<<t_fu->getID()<<" at cycle "<<(*path)[t_fu]<<" is too late for its mapped successors.\n";
+    delete path;
+    return NULL;
+  } else if (m_recurrenceFirst and t_dfgNode->isCritical() and
+             !fitsRecurrences(t_II, t_dfgNode, (*path)[t_fu])) {
+    cout<<"[DEBUG] DFG node "<<t_dfgNode->getID()<<" on CGRA node "<<t_fu->getID()<<" at cycle "<<(*path)[t_fu]<<" cannot keep its recurrence within II "<<t_II<<".\n";
+    delete path;
+    return NULL;
   }
   return path;
 }
@@ -372,9 +1385,10 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
   cout<<"[DEBUG] schedule dfg node["<<t_dfg->getID(t_dfgNode)<<"] onto fu["<<fu->getID()<<"] at cycle "<<(*t_path)[fu]<<" within II: "<<t_II<<endl;
 
   // Map the DFG node onto the CGRA nodes across cycles.
-  m_mapping[t_dfgNode] = fu;
+  setMapping(t_dfgNode, fu);
+  recordForRollback(fu);
   fu->setDFGNode(t_dfgNode, (*t_path)[fu], t_II, t_isStaticElasticCGRA);
-  m_mappingTiming[t_dfgNode] = (*t_path)[fu];
+  setMappingTiming(t_dfgNode, (*t_path)[fu]);
   // Route the dataflow onto the CGRA links across cycles.
   CGRANode* onePredCGRANode;//记录Path中第一个CGRA节点
   int onePredCGRANodeTiming;//记录Path中第一个CGRA节点对应的cycle
@@ -387,6 +1401,7 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
   }
   map<int, CGRANode*>::reverse_iterator riter=reorderPath->rbegin();//要布的DFG和在path中对应的cycle
   bool generatedOut = true;
+  bool isOnTree = true;
 	//对path从头向后布，直到最后的DFGNode,前面已经对执行目标节点的CGRANode进行了确定，下面过程实际就是对path上的CGRALink进行占据
   for (map<int, CGRANode*>::iterator iter=reorderPath->begin();
       iter!=reorderPath->end(); ++iter) {
@@ -406,10 +1421,25 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
       else
 				//应该是被认为除去上面的情况就是直接从路径的倒数第二个节点到最后一个节点
         duration = (m_mappingTiming[t_dfgNode]-(*previousIter).first)%t_II;
-      l->occupy(srcCGRANode->getMappedDFGNode(srcCycle),
-                (*previousIter).first, duration,
-                t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
+      // The links of the multicast tree already bypass the data.
+      DFGNode* srcDFGNode = srcCGRANode->getMappedDFGNode(srcCycle);
+      if (!m_multicastRouting or !isBypass or
+          (*iter).second->getMulticastArrival(srcDFGNode) != (*iter).first or
+          l->getMappedDFGNode((*previousIter).first) != srcDFGNode) {
+        addLinkPressure(l, (*previousIter).first);
+        recordForRollback(l);
+        l->occupy(srcDFGNode, (*previousIter).first, duration,
+                  t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
+      }
       generatedOut = false;//只有从path起始的节点对于CGRALink来说是数据输出
+      // Only the CGRANodes the data bypasses without a stop can forward it.
+      if (!isBypass)
+        isOnTree = false;
+      if (m_multicastRouting and isOnTree) {
+        recordForRollback((*iter).second);
+        (*iter).second->addMulticastArrival(srcDFGNode, (*iter).first,
+                                            (*previousIter).second->getID());
+      }
     } else {//第一个节点对应的是起始的CGRA节点,记录path的第一个节点
       onePredCGRANode = (*iter).second;
       onePredCGRANodeTiming = (*iter).first;
@@ -433,8 +1463,9 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
         continue;
       }
 //      if (m_mapping[(node)] != onePredCGRANode) {
-      if (!tryToRoute(t_cgra, t_dfg, t_II, node, m_mapping[node], t_dfgNode, fu,
-          m_mappingTiming[t_dfgNode], false, t_isStaticElasticCGRA)){
+      if (!tryToRoute(t_cgra, t_II, node, m_mapping[node], t_dfgNode, fu,
+          m_mappingTiming[t_dfgNode], isSkippedBackEdge(node, t_dfgNode),
+          t_isStaticElasticCGRA)){
         cout<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped pred DFG node: "<<node->getID()<<"; return false\n";
         return false;
       }
@@ -443,21 +1474,29 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
   }
 
   // Try to route the path with the mapped successors that are only in
-  // certain cycle.
-  for (DFGNode* node: *t_dfgNode->getSuccNodes()) {
-    if (m_mapping.find(node) != m_mapping.end()) {
-      bool bothNodesInCycle = false;
-      if (node->shareSameCycle(t_dfgNode) and
-          node->isCritical() and t_dfgNode->isCritical()) {//getCycleID() != -1 and
-//          node->isCritical() and t_dfgNode->isCritical() and
-//          node->getCycleID() == t_dfgNode->getCycleID()) {
-        bothNodesInCycle = true;
-      }
-      if (!tryToRoute(t_cgra, t_dfg, t_II, t_dfgNode, fu, node, m_mapping[node],
-          m_mappingTiming[node], bothNodesInCycle, t_isStaticElasticCGRA)) {
-        cout<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped succ DFG node: "<<node->getID()<<"; return false\n";
-        return false;
-      }
+  // certain cycle. The successors share one multicast tree, the nearest
+  // ones are routed first, so that the farther ones can branch from their
+  // routes.
+  list<DFGNode*> mappedSuccNodes;
+  for (DFGNode* node: *t_dfgNode->getSuccNodes())
+    if (m_mapping.find(node) != m_mapping.end())
+      mappedSuccNodes.push_back(node);
+  if (m_multicastRouting)
+    mappedSuccNodes.sort([&](DFGNode* a, DFGNode* b) {
+      return t_cgra->getHopDistance(fu, m_mapping[a]) <
+             t_cgra->getHopDistance(fu, m_mapping[b]); });
+  for (DFGNode* node: mappedSuccNodes) {
+    bool bothNodesInCycle = false;
+    if (node->shareSameCycle(t_dfgNode) and
+        node->isCritical() and t_dfgNode->isCritical()) {//getCycleID() != -1 and
+//        node->isCritical() and t_dfgNode->isCritical() and
+//        node->getCycleID() == t_dfgNode->getCycleID()) {
+      bothNodesInCycle = true;
+    }
+    if (!tryToRoute(t_cgra, t_II, t_dfgNode, fu, node, m_mapping[node],
+        m_mappingTiming[node], bothNodesInCycle, t_isStaticElasticCGRA)) {
+      cout<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped succ DFG node: "<<node->getID()<<"; return false\n";
+      return false;
     }
   }
   return true;
@@ -971,7 +2010,7 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
 // TODO: Should consider the unmapped predecessors.
 // TODO: Should consider the type of CGRA, say, a static in-elastic CGRA should
 //       join at the same successor at exact same cycle without pending.
-bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
+bool Mapper::tryToRoute(CGRA* t_cgra, int t_II,
     DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, DFGNode* t_dstDFGNode,
     CGRANode* t_dstCGRANode, int t_dstCycle, bool t_isBackedge,
     bool t_isStaticElasticCGRA) {
@@ -981,42 +2020,16 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
   map<CGRANode*, int> timing;
   map<CGRANode*, CGRANode*> previous;
   timing[t_srcCGRANode] = m_mappingTiming[t_srcDFGNode];
-  // Check whether the II is violated on each cycle.
-	// 这段代码是从环的角度来考虑，来排除错误情况，而后续的实现中不会有这样的情况，所以此处的阅读价值相对较小。
-  if (t_srcDFGNode->shareSameCycle(t_dstDFGNode)) {
-    list<list<DFGNode*>*>* dfgNodeCycles = t_dfg->getCycleLists();
-    for (list<DFGNode*>* cycle: *dfgNodeCycles) {
-			//判断所遍历的环中同时包括srcDFGNode和dstDFGNode
-      bool foundSrc = (find(cycle->begin(), cycle->end(), t_srcDFGNode) != cycle->end());
-      bool foundDst = (find(cycle->begin(), cycle->end(), t_dstDFGNode) != cycle->end());
-      if (!foundSrc or !foundDst) {
-        continue;
-      }
-			//if find a cycle which the srcDFGNode and dstDFGNode both belong to.
-      int totalTime = 0;
-      DFGNode* lastDFGNode = cycle->back();//上一个DFGNode,由于下面的dfgnode从cycle的头开始遍历，所以第一个dfgNode的上一个DFGNode是cycle中的最后一个DFGNode.
-      for (DFGNode* dfgNode: *cycle) {
-				//如果环中当前的node和上一个node有没被布的则跳出循环,认为这个环还没完全被布没法判断，对本个环的检查认为没有问题,跳出本层循环，回到外层循环检查下一个环。
-        if (m_mappingTiming.find(dfgNode) == m_mappingTiming.end() or
-            m_mappingTiming.find(lastDFGNode) == m_mappingTiming.end()) {
-          totalTime = 0;
-          break;
-        } else {
-					//对于可能完整的cycle,当前Node已经被布，上一个也已被布，计算totalTime
-          int t1 = m_mappingTiming[lastDFGNode];
-          int t2 = m_mappingTiming[dfgNode];
-          while (t1 >= t2) {
-            t2 += t_II;
-          }
-          totalTime += t2 - t1;
-        }
-        lastDFGNode = dfgNode;
-      }
-			//如果环中完整部分的totalTime>II则认为是不合法的，直接返回失败
-      if (totalTime > t_II) {
-        cout<<"[DEBUG] cannot route due to II is violated for backward cycle"<<endl;
-        return false;
-      }
+  // Check whether the II is violated on each cycle both DFGNodes are on,
+  // the time of a cycle is only complete once all of its DFGNodes are mapped.
+  for (int cycleID: *(t_srcDFGNode->getCycleIDs())) {
+    if (m_recurrencePositions[cycleID].find(t_dstDFGNode) ==
+        m_recurrencePositions[cycleID].end())
+      continue;
+    if (m_recurrenceMappedEdges[cycleID] == (int)m_recurrences[cycleID].size() and
+        m_recurrenceTime[cycleID] > t_II) {
+      cout<<"[DEBUG] cannot route due to II is violated for backward cycle"<<endl;
+      return false;
     }
   }
 	//给distance，timing，previous，searchPool结构赋初值timing[t_srcDFGNode]的初始化在前面已进行
@@ -1035,25 +2048,53 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
   }
 	//给起始CGRANode的距离赋值为0,作为路径的起始
   distance[t_srcCGRANode] = 0;
+  int srcTiming = timing[t_srcCGRANode];
+  // The data can also leave from the CGRANodes its multicast tree passes,
+  // at the cycle it passes them, so the links of the tree are reused rather
+  // than routed again (see canBranchFrom()).
+  if (m_multicastRouting) {
+    for (int i=0; i<t_cgra->getRows(); ++i) {
+      for (int j=0; j<t_cgra->getColumns(); ++j) {
+        CGRANode* node = t_cgra->nodes[i][j];
+        if (!canBranchFrom(t_cgra, t_srcDFGNode, t_srcCGRANode, node,
+            t_dstCGRANode, srcTiming))
+          continue;
+        distance[node] = node->getMulticastArrival(t_srcDFGNode) - srcTiming;
+        timing[node] = node->getMulticastArrival(t_srcDFGNode);
+      }
+    }
+  }
 	//在searchPool中进行寻找，每次删除一个cost最小的CGRA节点，第一个被删除的是srcCGRANode,然后会遍历srcCGRANode节点的所有邻节点，当distance比原来小时修改其distance，从srcCGRANode到此节点的难易程度即其cost，所以第二次删除的一定是srcCGRANode中的一个邻节点，同样会修改这个节点的邻节点的cost,直到找到目标CGRANode时退出。每次都记录一个previous，即记录当前节点的上一个节点是哪个，即记录了一条路径。
   while (searchPool.size()!=0) {
+    if (isCancelled())
+      return false;
     int minCost = m_maxMappingCycle + 1;
-    CGRANode* minNode;
-		//在searchPool中对所有的CGRANode进行遍历，寻找到distance最小的node,第一次必是srcCGRANode
+    CGRANode* minNode = NULL;
+		//在searchPool中对所有的CGRANode进行遍历，寻找到distance加上到dstCGRANode的hop distance最小的node (A*),第一次必是srcCGRANode
     for (CGRANode* currentNode: searchPool) {
-      if (distance[currentNode] < minCost) {
-        minCost = distance[currentNode];
+      if (distance[currentNode] >= m_maxMappingCycle)
+        continue;
+      int estimate = distance[currentNode];
+      if (m_aStarRouting)
+        estimate += t_cgra->getHopDistance(currentNode, t_dstCGRANode);
+      if (estimate < minCost) {
+        minCost = estimate;
         minNode = currentNode;
       }
     }
+    // The rest of the CGRA nodes are not reachable.
+    if (minNode == NULL)
+      break;
     searchPool.remove(minNode);
-    // found the target point in the shortest path
-    if (minNode == t_dstCGRANode) {
-      if (previous[minNode] == NULL)
-        break;
-    }
+    // found the target point in the shortest path, the hop distance is
+    // consistent, so the path to it cannot be shortened any more.
+    if (minNode == t_dstCGRANode)
+      break;
     list<CGRANode*>* currentNeighbors = minNode->getNeighbors();
 
+    // The data only passes the CGRANodes of the multicast tree, it cannot
+    // wait there.
+    bool isTreeNode = previous[minNode] == NULL and minNode != t_srcCGRANode;
     for (CGRANode* neighbor: *currentNeighbors) {
       int cycle = timing[minNode];
       while (1) {
@@ -1070,13 +2111,14 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
           break;
         }
         ++cycle;
-        if(cycle > m_maxMappingCycle)
+        if(cycle > m_maxMappingCycle or isTreeNode)
           break;
       }
     }
   }
 
-  // Construct the shortest path for routing.
+  // Construct the shortest path for routing, it starts from either the
+  // srcCGRANode or a CGRANode of the multicast tree.
 	//根据previous来生成一条从srcCGRANode到dstCGRANode的路径
   map<CGRANode*, int> path;
   CGRANode* u = t_dstCGRANode;
@@ -1114,9 +2156,10 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
   if (reorderPath->size() == 1) {
     int duration = (t_II+(t_dstCycle-(*riter).first)%t_II)%t_II;
     cout<<"[DEBUG] allocate for local reg maintain... duration="<<duration<<" last cycle: "<<(*riter).first<<"\n";
+    recordForRollback((*riter).second);
     (*riter).second->allocateReg(4, (*riter).first, duration, t_II);
   }
-  bool generatedOut = true;
+  bool generatedOut = (*(reorderPath->begin())).second == t_srcCGRANode;
   for (map<int, CGRANode*>::iterator iter = reorderPath->begin();
       iter!=reorderPath->end(); ++iter) {
     if (iter != reorderPath->begin()) {
@@ -1140,6 +2183,8 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
         }
         duration = t_II;
       }
+      addLinkPressure(l, (*previousIter).first);
+      recordForRollback(l);
       l->occupy(t_srcDFGNode, (*previousIter).first,
                 duration, t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
       generatedOut = false;
@@ -1152,11 +2197,27 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
 
   // Check whether the backward data can be delivered within II.
   if (!t_isStaticElasticCGRA) {
-    if (t_isBackedge and (*end).first - (*begin).first >= t_II) {
+    if (t_isBackedge and (*end).first - srcTiming >= t_II) {
       cout<<"[DEBUG] cannot route due to backedge data cannot be delivered in time"<<endl;
       return false;
     }
   }
+
+  // Record the route in the multicast tree of the data.
+  if (m_multicastRouting) {
+    if ((*begin).second != t_srcCGRANode)
+      cout<<"[DEBUG] multicast dfgNode: "<<t_srcDFGNode->getID()<<" branches from CGRA node "<<(*begin).second->getID()<<" at cycle "<<(*begin).first<<"\n";
+    // Only the CGRANodes the data bypasses without a stop can forward it.
+    for (map<int, CGRANode*>::iterator iter=next(reorderPath->begin());
+        iter!=reorderPath->end(); ++iter) {
+      if ((*iter).second == t_dstCGRANode or
+          (*prev(iter)).first + 1 != (*iter).first)
+        break;
+      recordForRollback((*iter).second);
+      (*iter).second->addMulticastArrival(t_srcDFGNode, (*iter).first,
+                                          (*prev(iter)).second->getID());
+    }
+  }
   return true;
 }
 
@@ -1167,66 +2228,110 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
  * 3. Traverse each DFGNodes in t_dfg, attempt to map each DFGNode.
  * 4. For each DFGNodes, Traverse each CGRANodes in CGRA to find possible paths. the DFGNode to each CGRANode is a path: map<CGRANode*,int>,the int is clock cycles, the paths is a list list<map<CGRANode*,int>> 
  * 4. For each DFGNodes, find the path with min cost and constraints from paths
+ * 5. If m_warmStart is true, each DFGNode tries the CGRANode of the failed II first (scheduleWarmStart()). A DFGNode that still cannot be placed evicts the DFGNodes in the way (scheduleByEviction()), they lose their former CGRANode and are placed again, at most once per DFGNode on average.
  */
 int Mapper::heuristicMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
     bool t_isStaticElasticCGRA) {
   bool fail = false;
+  m_warmStartMapping.clear();
   while (1) {
     cout<<"----------------------------------------\n";
     cout<<"[DEBUG] start heuristic algorithm with II="<<t_II<<"\n";
+    // Each II starts from the seed, so that a seed reported by
+    // multiStartMap() at this II gives the same mapping.
+    if (m_randomSeed != -1)
+      m_random.seed(m_randomSeed);
     int cycle = 0;
     constructMRRG(t_dfg, t_cgra, t_II); //里面创建了很多变量，而且后面好像没有deleate导致内存爆炸
     fail = false;
- 		// 3. Traverse each DFGNodes in t_dfg, attempt to map each DFGNode.
-    for (list<DFGNode*>::iterator dfgNode=t_dfg->nodes.begin();
-        dfgNode!=t_dfg->nodes.end(); ++dfgNode) {
-      list<map<CGRANode*, int>*> paths;
- 			// 4. For each DFGNodes, Traverse each CGRANodes in CGRA to find possible paths.
-      for (int i=0; i<t_cgra->getRows(); ++i) {
-        for (int j=0; j<t_cgra->getColumns(); ++j) {
-          CGRANode* fu = t_cgra->nodes[i][j];
-          map<CGRANode*, int>* tempPath =
-              calculateCost(t_cgra, t_dfg, t_II, *dfgNode, fu); 
-          if(tempPath != NULL and tempPath->size() != 0) {
-            paths.push_back(tempPath);
-          } else {
-            cout<<"[DEBUG] no available path for DFG node "<<(*dfgNode)->getID()
-                <<" on CGRA node "<<fu->getID()<<" within II "<<t_II<<"; path size: "<<paths.size()<<".\n";
-          }
-        }
-      }
-      // Found some potential mappings.
-      if (paths.size() != 0) {
-        map<CGRANode*, int>* optimalPath =
-            getPathWithMinCostAndConstraints(t_cgra, t_dfg, t_II, *dfgNode, &paths);
-        if (optimalPath->size() != 0) {
-          if (!schedule(t_cgra, t_dfg, t_II, *dfgNode, optimalPath,
-              t_isStaticElasticCGRA)) {
-            cout<<"[DEBUG] fail1 in schedule() II: "<<t_II<<"\n";
-            for (map<CGRANode*,int>::iterator iter = optimalPath->begin();
-                iter!=optimalPath->end(); ++iter) {
-              cout<<"[DEBUG] the failed path -- cycle: "<<(*iter).second<<" CGRANode: "<<(*iter).first->getID()<<"\n";
-            }
-
-            fail = true;
-            break;
-          }
-          cout<<"[DEBUG] success in schedule()\n";
-        } else {
-          cout<<"[DEBUG] fail2 in schedule() II: "<<t_II<<"\n";
-          fail = true;
+    // Record the successful schedules, so that a failed schedule() can be
+    // undone by replaying them.
+    list<DFGNode*> scheduledDFGNodes;
+    list<map<CGRANode*, int>*> scheduledPaths;
+    DFGNode* failedDFGNode = NULL;
+    // Only the conflicts of a warm start are repaired by eviction.
+    bool isWarmStarted = m_warmStartMapping.size() != 0;
+    map<DFGNode*, int> lastForcedCycle;
+    int budget = t_dfg->getNodeCount();
+    int evictions = 0;
+ 		// 3. Traverse each DFGNodes in the mapping order, attempt to map each DFGNode.
+    list<DFGNode*>* mappingOrder = getMappingOrder(t_dfg);
+    while (1) {
+      DFGNode* targetDFGNode = NULL;
+      for (DFGNode* dfgNode: *mappingOrder) {
+        if (m_mapping.find(dfgNode) == m_mapping.end()) {
+          targetDFGNode = dfgNode;
           break;
         }
-      } else {
+      }
+      if (targetDFGNode == NULL)
+        break;
+      if (isCancelled()) {
         fail = true;
-        cout<<"[DEBUG] *else* no available path for DFG node "<<(*dfgNode)->getID()
-            <<" within II "<<t_II<<".\n";
         break;
+      }
+ 			// 4. For each DFGNodes, find the path with min cost and constraints,
+ 			//    fall back to the next ones if schedule() fails. With the warm
+ 			//    start, the CGRANode of the failed II is tried first.
+      if (scheduleWarmStart(t_cgra, t_dfg, t_II, targetDFGNode,
+          &scheduledDFGNodes, &scheduledPaths, t_isStaticElasticCGRA) or
+          scheduleWithRollback(t_cgra, t_dfg, t_II, targetDFGNode,
+          &scheduledDFGNodes, &scheduledPaths, t_isStaticElasticCGRA)) {
+        cout<<"[DEBUG] success in schedule()\n";
+        continue;
+      }
+      // 5. Evict the DFGNodes in the way of the warm start, they are placed
+      //    again without their former CGRANodes.
+      if (isWarmStarted and budget > 0) {
+        --budget;
+        list<DFGNode*> formerDFGNodes(scheduledDFGNodes);
+        scheduleByEviction(t_cgra, t_dfg, t_II, targetDFGNode,
+            &scheduledDFGNodes, &scheduledPaths, &lastForcedCycle,
+            &evictions, t_isStaticElasticCGRA);
+        for (DFGNode* dfgNode: formerDFGNodes)
+          if (m_mapping.find(dfgNode) == m_mapping.end())
+            m_warmStartMapping.erase(dfgNode);
+        continue;
+      }
+      cout<<"[DEBUG] fail2 in schedule() II: "<<t_II<<"\n";
+      failedDFGNode = targetDFGNode;
+      fail = true;
+      break;
+    }
+    delete mappingOrder;
+    if (isWarmStarted)
+      cout<<"[DEBUG] warm start II="<<t_II<<" evictions: "<<evictions<<" remaining budget: "<<budget<<"\n";
+    // Keep the placement of the scheduled DFGNodes for the next II, the
+    // DFGNodes placed by placeUnmapped() below are not worth repeating.
+    // The neighbors of the DFGNode that fails are where the conflict is,
+    // they are placed from scratch.
+    m_warmStartMapping.clear();
+    if (failedDFGNode != NULL and m_warmStart) {
+      for (DFGNode* dfgNode: scheduledDFGNodes) {
+        list<DFGNode*>* preds = failedDFGNode->getPredNodes();
+        list<DFGNode*>* succs = failedDFGNode->getSuccNodes();
+        if (find(preds->begin(), preds->end(), dfgNode) == preds->end() and
+            find(succs->begin(), succs->end(), dfgNode) == succs->end())
+          m_warmStartMapping[dfgNode] = m_mapping[dfgNode];
+      }
+    }
+    // 6. The greedy routing failed, keep the placement of the scheduled
+    //    DFGNodes, place the rest, and negotiate the routing of all the
+    //    DFGEdges before giving up the II.
+    if (fail and m_pathFinderIterations > 0 and !t_isStaticElasticCGRA and
+        !isCancelled()) {
+      cout<<"[DEBUG] start negotiated routing with II="<<t_II<<"\n";
+      replaySchedule(t_cgra, t_dfg, t_II, &scheduledDFGNodes,
+          &scheduledPaths, t_isStaticElasticCGRA);
+      if (placeUnmapped(t_cgra, t_dfg, t_II, true) and
+          negotiatedRoute(t_cgra, t_dfg, t_II)) {
+        fail = false;
       }
     }
     if (!fail)
       break;
-    else if (t_isStaticElasticCGRA) {
+    else if (t_isStaticElasticCGRA or isCancelled() or
+             (m_maxII != -1 and t_II >= m_maxII)) {
       break;
     }
     ++t_II;
@@ -1237,102 +2342,1619 @@ int Mapper::heuristicMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
     return -1;
 }
 
-int Mapper::exhaustiveMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
-    bool t_isStaticElasticCGRA) {
-  list<map<CGRANode*, int>*>* exhaustivePaths = new list<map<CGRANode*, int>*>();
-  list<DFGNode*>* mappedDFGNodes = new list<DFGNode*>();
-  bool success = DFSMap(t_cgra, t_dfg, t_II, mappedDFGNodes,
-      exhaustivePaths, t_isStaticElasticCGRA);
-  if (success)
-    return t_II;
-  else
-    return -1;
+/**
+ * what is in this function:
+ * 1. For each unmapped DFGNode in the priority order (getPriorityOrder()), estimate the earliest arriving cycle on each CGRANode from its placed predecessors.
+ * 2. find the earliest cycle within II that the CGRANode can be occupied, skip it if a placed successor cannot be reached in time (only if t_isTimingStrict).
+ * 3. choose the CGRANode with the min cost (cycle + distance to the placed neighbors), and map the DFGNode onto it.
+ */
+bool Mapper::placeUnmapped(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isTimingStrict) {
+  list<DFGNode*>* priorityOrder = getPriorityOrder(t_dfg);
+  for (DFGNode* dfgNode: *priorityOrder) {
+    if (m_mapping.find(dfgNode) != m_mapping.end())
+      continue;
+    CGRANode* bestFU = NULL;
+    int bestCycle = 0;
+    float minCost = 0;
+    for (int i=0; i<t_cgra->getRows(); ++i) {
+      for (int j=0; j<t_cgra->getColumns(); ++j) {
+        CGRANode* fu = t_cgra->nodes[i][j];
+        if (!fu->canSupport(dfgNode))
+          continue;
+        int earliest = 0;
+        int distance = 0;
+        bool isAnyPredPlaced = false;
+        for (DFGNode* pred: *(dfgNode->getPredNodes())) {
+          if (m_mapping.find(pred) == m_mapping.end() or
+              isBackEdge(pred, dfgNode))
+            continue;
+          isAnyPredPlaced = true;
+          int hops = t_cgra->getHopDistance(m_mapping[pred], fu);
+          distance += hops;
+          int arrival = m_mappingTiming[pred] + pred->getExecLatency() - 1 +
+                        (hops > 0 ? hops : 1);
+          if (arrival > earliest)
+            earliest = arrival;
+        }
+        // Without any placed predecessor, e.g., in the bottom-up part of the
+        // swing order, try the last II cycles the placed successors allow.
+        if (!isAnyPredPlaced) {
+          int latest = m_maxMappingCycle;
+          for (DFGNode* succ: *(dfgNode->getSuccNodes())) {
+            if (m_mapping.find(succ) == m_mapping.end() or
+                isBackEdge(dfgNode, succ))
+              continue;
+            int hops = t_cgra->getHopDistance(fu, m_mapping[succ]);
+            int deadline = m_mappingTiming[succ] - (hops > 0 ? hops : 1) -
+                           (dfgNode->getExecLatency() - 1);
+            if (deadline < latest)
+              latest = deadline;
+          }
+          if (latest < m_maxMappingCycle and latest - t_II + 1 > earliest)
+            earliest = latest - t_II + 1;
+          // Leave the room for the predecessors as in calculateCost().
+          else if (latest == m_maxMappingCycle and
+                   m_mappingOrder == SWING_MAPPING_ORDER)
+            earliest = m_swingSeedStretch * m_asap[dfgNode];
+        }
+        int cycle = earliest;
+        while (cycle < earliest + t_II and cycle < m_maxMappingCycle and
+               !fu->canOccupy(dfgNode, cycle, t_II))
+          ++cycle;
+        if (cycle >= earliest + t_II or cycle >= m_maxMappingCycle)
+          continue;
+        // The data to the placed successors can be delayed by at most one
+        // iteration.
+        bool reachable = true;
+        for (DFGNode* succ: *(dfgNode->getSuccNodes())) {
+          if (m_mapping.find(succ) == m_mapping.end())
+            continue;
+          int hops = t_cgra->getHopDistance(fu, m_mapping[succ]);
+          distance += hops;
+          if (cycle + dfgNode->getExecLatency() - 1 + (hops > 0 ? hops : 1) >
+              m_mappingTiming[succ] + t_II)
+            reachable = false;
+        }
+        if (!reachable and t_isTimingStrict)
+          continue;
+        float cost = cycle + distance;
+        if ((!dfgNode->isLoad() and fu->canLoad()) or
+            (!dfgNode->isStore() and fu->canStore()))
+          cost += m_memoryTileCost;
+        if (bestFU == NULL or cost < minCost) {
+          bestFU = fu;
+          bestCycle = cycle;
+          minCost = cost;
+        }
+      }
+    }
+    if (bestFU == NULL) {
+      cout<<"[DEBUG] cannot place DFG node "<<dfgNode->getID()<<" for negotiated routing within II "<<t_II<<"\n";
+      delete priorityOrder;
+      return false;
+    }
+    cout<<"[DEBUG] place dfg node["<<dfgNode->getID()<<"] onto fu["<<bestFU->getID()<<"] at cycle "<<bestCycle<<" for negotiated routing\n";
+    setMapping(dfgNode, bestFU);
+    setMappingTiming(dfgNode, bestCycle);
+    bestFU->setDFGNode(dfgNode, bestCycle, t_II, false);
+  }
+  delete priorityOrder;
+  return true;
 }
 
-bool Mapper::DFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
-    list<DFGNode*>* t_mappedDFGNodes,
-    list<map<CGRANode*, int>*>* t_exhaustivePaths,
-    bool t_isStaticElasticCGRA) {
-//  , DFGNode* t_badMappedDFGNode) {
+/**
+ * what is in this function:
+ * 1. collect the DFGEdges with their time windows, the data leaves the source CGRANode no earlier than the source DFGNode finishes, and arrives the destination CGRANode no later than the destination DFGNode starts (one iteration later for the data through the back edges, in the order of DFG).
+ * 2. rip up and reroute every DFGEdge with searchCongestedRoute(), update the present congestion on the fly.
+ * 3. if no CGRALink slot is overused, construct the MRRG again and commit the routing, the slots rejected by the MRRG (e.g., bypass constraint) are treated as congested.
+ * 4. otherwise increase the history cost of the overused slots and the present factor, and go to step 2.
+ */
+bool Mapper::negotiatedRoute(CGRA* t_cgra, DFG* t_dfg, int t_II) {
+  vector<DFGNode*> srcDFGNodes;
+  vector<DFGNode*> dstDFGNodes;
+  vector<int> departures;
+  vector<int> deadlines;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    for (DFGNode* succ: *(dfgNode->getSuccNodes())) {
+      int departure = m_mappingTiming[dfgNode] + dfgNode->getExecLatency() - 1;
+      int deadline = m_mappingTiming[succ];
+      // Only the data through a back edge is for the next iteration, a
+      // forward edge arriving that late is a timing violation.
+      if (isBackEdge(dfgNode, succ))
+        deadline += t_II;
+      int hops = t_cgra->getHopDistance(m_mapping[dfgNode], m_mapping[succ]);
+      if (deadline <= departure or deadline - departure < hops or
+          deadline >= m_maxMappingCycle) {
+        cout<<"[DEBUG] negotiated routing fails due to the timing of DFG node "<<dfgNode->getID()<<" -> "<<succ->getID()<<"\n";
+        return false;
+      }
+      srcDFGNodes.push_back(dfgNode);
+      dstDFGNodes.push_back(succ);
+      departures.push_back(departure);
+      deadlines.push_back(deadline);
+    }
+  }
 
-//  list<map<CGRANode*, int>*>* exhaustivePaths = t_exhaustivePaths;
+  int edgeCount = srcDFGNodes.size();
+  int slotCount = t_cgra->getLinkCount() * t_II;
+  vector<map<DFGNode*, int>> slotUsers(slotCount);
+  vector<float> history(slotCount, 0.0);
+  vector<list<pair<CGRALink*, int>>> routes(edgeCount);
+  float presentFactor = m_presentFactor;
+  for (int iteration=0; iteration<m_pathFinderIterations; ++iteration) {
+    if (isCancelled())
+      return false;
+    for (int e=0; e<edgeCount; ++e) {
+      // Rip up.
+      for (pair<CGRALink*, int> hop: routes[e]) {
+        int slot = hop.first->getID() * t_II + hop.second % t_II;
+        if (--slotUsers[slot][srcDFGNodes[e]] == 0)
+          slotUsers[slot].erase(srcDFGNodes[e]);
+      }
+      routes[e].clear();
+      // Reroute.
+      if (!searchCongestedRoute(t_cgra, t_II, srcDFGNodes[e],
+          m_mapping[srcDFGNodes[e]], m_mapping[dstDFGNodes[e]],
+          departures[e], deadlines[e], presentFactor, &slotUsers, &history,
+          &routes[e])) {
+        cout<<"[DEBUG] negotiated routing fails since DFG node "<<srcDFGNodes[e]->getID()<<" -> "<<dstDFGNodes[e]->getID()<<" cannot be routed within its time window\n";
+        return false;
+      }
+      for (pair<CGRALink*, int> hop: routes[e])
+        ++slotUsers[hop.first->getID() * t_II + hop.second % t_II][srcDFGNodes[e]];
+    }
 
-  constructMRRG(t_dfg, t_cgra, t_II);
+    int overused = 0;
+    for (int slot=0; slot<slotCount; ++slot) {
+      if (slotUsers[slot].size() > 1) {
+        overused += slotUsers[slot].size() - 1;
+        history[slot] += slotUsers[slot].size() - 1;
+      }
+    }
+    cout<<"[DEBUG] negotiated routing iteration "<<iteration<<" overused link slots: "<<overused<<"\n";
+    presentFactor *= m_presentGrowth;
+    if (overused > 0)
+      continue;
 
-//  list<DFGNode*> dfgNodeSearchPool;
-//  for (list<DFGNode*>::iterator dfgNodeItr=dfg->nodes.begin();
-//      dfgNodeItr!=dfg->nodes.end(); ++dfgNodeItr) {
-//    dfgNodeSearchPool.push_back(*dfgNodeItr);
-//  }
+    // Commit the routing onto the MRRG.
+    t_cgra->constructMRRG(t_II);
+    for (DFGNode* dfgNode: t_dfg->nodes) {
+      m_mapping[dfgNode]->setDFGNode(dfgNode, m_mappingTiming[dfgNode],
+          t_II, false);
+    }
+    bool committed = true;
+    for (int e=0; e<edgeCount and committed; ++e) {
+      CGRANode* srcCGRANode = m_mapping[srcDFGNodes[e]];
+      CGRANode* dstCGRANode = m_mapping[dstDFGNodes[e]];
+      if (routes[e].size() == 0) {
+        int duration = (t_II+(deadlines[e]-departures[e])%t_II)%t_II;
+        srcCGRANode->allocateReg(4, departures[e], duration, t_II);
+        continue;
+      }
+      bool generatedOut = true;
+      for (list<pair<CGRALink*, int>>::iterator hop=routes[e].begin();
+          hop!=routes[e].end(); ++hop) {
+        CGRALink* l = (*hop).first;
+        int cycle = (*hop).second;
+        if (!l->canOccupy(srcDFGNodes[e], srcCGRANode, cycle, t_II)) {
+          cout<<"[DEBUG] negotiated routing is rejected by link["<<l->getSrc()->getID()<<"]-->["<<l->getDst()->getID()<<"] at cycle "<<cycle<<"\n";
+          history[l->getID() * t_II + cycle % t_II] += 1;
+          committed = false;
+          break;
+        }
+        list<pair<CGRALink*, int>>::iterator next = hop;
+        ++next;
+        int leave = (next == routes[e].end()) ? deadlines[e] : (*next).second;
+        bool isBypass = (l->getDst() != dstCGRANode and leave == cycle + 1);
+        addLinkPressure(l, cycle);
+        l->occupy(srcDFGNodes[e], cycle, leave - cycle, t_II, isBypass,
+                  generatedOut, false);
+        generatedOut = false;
+      }
+    }
+    if (committed) {
+      cout<<"[DEBUG] negotiated routing succeeds after "<<iteration+1<<" iterations with II="<<t_II<<"\n";
+      return true;
+    }
+  }
+  return false;
+}
 
-  list<DFGNode*>::iterator mappedDFGNodeItr = t_mappedDFGNodes->begin();
-  list<DFGNode*>::iterator dfgNodeItr = t_dfg->nodes.begin();
-//  list<DFGNode*>::iterator dfgNodeItr = t_dfg->getDFSOrderedNodes()->begin();
-  for (map<CGRANode*, int>* path: *t_exhaustivePaths) {
-    if (!schedule(t_cgra, t_dfg, t_II, *mappedDFGNodeItr, path,
-        t_isStaticElasticCGRA)) {
-      cout<<"DEBUG <this is impossible> fail3 in DFS() II: "<<t_II<<"\n";
-      assert(0);
+/**
+ * what is in this function:
+ * 1. the state is a CGRANode at a cycle, the data can stay in the CGRANode for one more cycle, or go through an out CGRALink to the neighbor in the next cycle.
+ * 2. the cost of a CGRALink slot is (1 + history) * (1 + presentFactor * the number of other source DFGNodes on it), reusing the slot of the same source DFGNode (multicast) costs m_sharedLinkCost, staying in the register costs m_registerHoldCost.
+ * 3. dijkstra from (t_srcCGRANode, t_departure) until t_dstCGRANode is reached no later than t_deadline.
+ */
+bool Mapper::searchCongestedRoute(CGRA* t_cgra, int t_II,
+    DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, CGRANode* t_dstCGRANode,
+    int t_departure, int t_deadline, float t_presentFactor,
+    vector<map<DFGNode*, int>>* t_slotUsers, vector<float>* t_history,
+    list<pair<CGRALink*, int>>* t_route) {
+  if (t_srcCGRANode == t_dstCGRANode)
+    return true;
+  int window = t_deadline - t_departure + 1;
+  int stateCount = t_cgra->getFUCount() * window;
+  vector<float> cost(stateCount, -1);
+  vector<int> previous(stateCount, -1);
+  vector<CGRALink*> previousLink(stateCount, NULL);
+  vector<CGRANode*> cgraNodes(t_cgra->getFUCount(), NULL);
+  for (int i=0; i<t_cgra->getRows(); ++i)
+    for (int j=0; j<t_cgra->getColumns(); ++j)
+      cgraNodes[t_cgra->nodes[i][j]->getID()] = t_cgra->nodes[i][j];
+
+  priority_queue<pair<float, int>, vector<pair<float, int>>,
+                 greater<pair<float, int>>> searchPool;
+  int srcState = t_srcCGRANode->getID() * window;
+  cost[srcState] = 0;
+  searchPool.push(make_pair(0.0, srcState));
+  int dstState = -1;
+  vector<bool> visited(stateCount, false);
+  while (!searchPool.empty()) {
+    if (isCancelled())
+      return false;
+    int state = searchPool.top().second;
+    searchPool.pop();
+    if (visited[state])
+      continue;
+    visited[state] = true;
+    CGRANode* current = cgraNodes[state / window];
+    int offset = state % window;
+    if (current == t_dstCGRANode) {
+      dstState = state;
       break;
     }
-    ++mappedDFGNodeItr;
-//    dfgNodeSearchPool.remove(*dfgNodeItr);
-    ++dfgNodeItr;
+    if (offset + 1 >= window)
+      continue;
+    // Stay in the register of the current CGRANode.
+    list<pair<int, float>> moves;
+    moves.push_back(make_pair(state + 1, (float)m_registerHoldCost));
+    // Go through an out CGRALink.
+    list<CGRALink*> outLinks;
+    for (CGRALink* l: *(current->getOutLinks())) {
+      if (l->isDisabled())
+        continue;
+      int slot = l->getID() * t_II + (t_departure + offset) % t_II;
+      map<DFGNode*, int>* users = &((*t_slotUsers)[slot]);
+      float linkCost = m_sharedLinkCost;
+      if (users->find(t_srcDFGNode) == users->end()) {
+        linkCost = (1 + (*t_history)[slot]) *
+                   (1 + t_presentFactor * users->size());
+      }
+      int next = l->getDst()->getID() * window + offset + 1;
+      moves.push_back(make_pair(next, linkCost));
+      outLinks.push_back(l);
+    }
+    list<CGRALink*>::iterator linkItr = outLinks.begin();
+    bool isStay = true;
+    for (pair<int, float> move: moves) {
+      float nextCost = cost[state] + move.second;
+      if (!visited[move.first] and
+          (cost[move.first] < 0 or nextCost < cost[move.first])) {
+        cost[move.first] = nextCost;
+        previous[move.first] = state;
+        previousLink[move.first] = isStay ? NULL : *linkItr;
+        searchPool.push(make_pair(nextCost, move.first));
+      }
+      if (!isStay)
+        ++linkItr;
+      isStay = false;
+    }
   }
-//  if (dfgNodeSearchPool.size() == 0) {
-  if (dfgNodeItr == t_dfg->nodes.end())
-    return true;
-//  }
+  if (dstState == -1)
+    return false;
+
+  // Get the cheapest route.
+  for (int state=dstState; previous[state] != -1; state=previous[state]) {
+    if (previousLink[state] != NULL) {
+      t_route->push_front(make_pair(previousLink[state],
+          t_departure + previous[state] % window));
+    }
+  }
+  return true;
+}
 
-  DFGNode* targetDFGNode = *dfgNodeItr;
+/**
+ * what is in this function:
+ * 1. find the CGRANode t_dfgNode was scheduled onto in the failed II, and use calculateCost to find its path at the current II.
+ * 2. schedule the path, undo the partial schedule with replaySchedule() if it fails.
+ */
+bool Mapper::scheduleWarmStart(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, list<DFGNode*>* t_scheduledDFGNodes,
+    list<map<CGRANode*, int>*>* t_scheduledPaths,
+    bool t_isStaticElasticCGRA) {
+  map<DFGNode*, CGRANode*>::iterator former =
+      m_warmStartMapping.find(t_dfgNode);
+  if (former == m_warmStartMapping.end())
+    return false;
+  CGRANode* fu = (*former).second;
+  map<CGRANode*, int>* path =
+      calculateCost(t_cgra, t_dfg, t_II, t_dfgNode, fu);
+  if (path == NULL or path->size() == 0 or (*path)[fu] >= m_maxMappingCycle) {
+    cout<<"[DEBUG] warm start: DFG node "<<t_dfgNode->getID()<<" cannot stay on CGRA node "<<fu->getID()<<" within II "<<t_II<<".\n";
+    delete path;
+    return false;
+  }
+  if (schedule(t_cgra, t_dfg, t_II, t_dfgNode, path, t_isStaticElasticCGRA) and
+      (!m_forwardChecking or forwardCheck(t_II, t_dfgNode))) {
+    cout<<"[DEBUG] warm start: DFG node "<<t_dfgNode->getID()<<" stays on CGRA node "<<fu->getID()<<" at cycle "<<(*path)[fu]<<".\n";
+    t_scheduledDFGNodes->push_back(t_dfgNode);
+    t_scheduledPaths->push_back(path);
+    return true;
+  }
+  cout<<"[DEBUG] warm start: fail to schedule DFG node "<<t_dfgNode->getID()<<" on CGRA node "<<fu->getID()<<" II: "<<t_II<<"\n";
+  replaySchedule(t_cgra, t_dfg, t_II, t_scheduledDFGNodes,
+      t_scheduledPaths, t_isStaticElasticCGRA);
+  delete path;
+  return false;
+}
 
-  list<map<CGRANode*, int>*> paths;
+/**
+ * what is in this function:
+ * 1. For each CGRANode, use calculateCost to find the possible path of t_dfgNode.
+ * 2. reorder the paths according to the cost.
+ * 3. try to schedule the paths one by one, the CGRANodes and CGRALinks record the changes of schedule(), and undo them after a failed one, so only the occupancy of t_dfgNode is undone.
+ * 4. delete the paths that are not scheduled.
+ */
+bool Mapper::scheduleWithRollback(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, list<DFGNode*>* t_scheduledDFGNodes,
+    list<map<CGRANode*, int>*>* t_scheduledPaths,
+    bool t_isStaticElasticCGRA) {
+  // Without any mapped predecessor, calculateCost() does not route, so
+  // there is nothing to save.
+  bool isAnyPredDFGNodeMapped = false;
+  for (DFGNode* pred: *(t_dfgNode->getPredNodes()))
+    if (m_mapping.find(pred) != m_mapping.end() and
+        !isSkippedBackEdge(pred, t_dfgNode))
+      isAnyPredDFGNodeMapped = true;
+  bool isLazy = m_lazyCandidateEvaluation and isAnyPredDFGNodeMapped and
+                isCostLowerBoundAdmissible();
+  list<pair<float, CGRANode*>> candidates;
   for (int i=0; i<t_cgra->getRows(); ++i) {
     for (int j=0; j<t_cgra->getColumns(); ++j) {
       CGRANode* fu = t_cgra->nodes[i][j];
-      map<CGRANode*, int>* tempPath =
-          calculateCost(t_cgra, t_dfg, t_II, targetDFGNode, fu);
-      if(tempPath != NULL and tempPath->size() != 0) {
-        paths.push_back(tempPath);
+      float bound = 0;
+      if (isLazy) {
+        if (!fu->canSupport(t_dfgNode))
+          continue;
+        bound = getCostLowerBound(t_cgra, t_dfg, t_dfgNode, fu);
       }
+      candidates.push_back(make_pair(bound, fu));
     }
   }
+  candidates.sort([](const pair<float, CGRANode*>& a,
+      const pair<float, CGRANode*>& b) { return a.first < b.first; });
+
+  // Only the top (m_rollbackCandidates + 1) paths can be tried, so stop
+  // once the next lower bound cannot beat the worst of them. With the
+  // random tie breaking in getOrderedPotentialPaths(), a path of the same
+  // cost can still win.
+  map<CGRANode*, map<CGRANode*, int>*> routedPaths;
+  list<float> bestCosts;
+  int routed = 0;
+  for (pair<float, CGRANode*> candidate: candidates) {
+    if (isLazy and (int)bestCosts.size() > m_rollbackCandidates and
+        (bestCosts.back() < candidate.first or
+         (m_randomSeed == -1 and bestCosts.back() == candidate.first)))
+      break;
+    CGRANode* fu = candidate.second;
+    ++routed;
+    map<CGRANode*, int>* tempPath =
+        calculateCost(t_cgra, t_dfg, t_II, t_dfgNode, fu);
+    if(tempPath != NULL and tempPath->size() != 0) {
+      routedPaths[fu] = tempPath;
+      if (isLazy and (*tempPath)[fu] < m_maxMappingCycle) {
+        float cost = getPathCost(t_cgra, t_dfg, t_II, t_dfgNode, tempPath);
+        list<float>::iterator position = bestCosts.begin();
+        while (position != bestCosts.end() and *position <= cost)
+          ++position;
+        bestCosts.insert(position, cost);
+        if ((int)bestCosts.size() > m_rollbackCandidates + 1)
+          bestCosts.pop_back();
+      }
+    } else {
+      cout<<"[DEBUG] no available path for DFG node "<<t_dfgNode->getID()
+          <<" on CGRA node "<<fu->getID()<<" within II "<<t_II<<"; path size: "<<routedPaths.size()<<".\n";
+      delete tempPath;
+    }
+  }
+  if (isLazy)
+    cout<<"[DEBUG] lazy evaluation routes "<<routed<<" of "<<t_cgra->getFUCount()<<" CGRA nodes for DFG node "<<t_dfgNode->getID()<<"\n";
+  // Keep the order of the CGRA nodes, so that the ties are broken in the
+  // same way as routing all of them.
+  list<map<CGRANode*, int>*> paths;
+  for (int i=0; i<t_cgra->getRows(); ++i)
+    for (int j=0; j<t_cgra->getColumns(); ++j)
+      if (routedPaths.find(t_cgra->nodes[i][j]) != routedPaths.end())
+        paths.push_back(routedPaths[t_cgra->nodes[i][j]]);
+  if (paths.size() == 0) {
+    cout<<"[DEBUG] *else* no available path for DFG node "<<t_dfgNode->getID()
+        <<" within II "<<t_II<<".\n";
+    return false;
+  }
 
+  // Try the candidates in the order of cost. Once the top-ranked one
+  // fails in schedule(), undo what it changed and fall back to the next
+  // ones. Only t_dfgNode is mapped by schedule(), the other DFGNodes keep
+  // their mapping.
   list<map<CGRANode*, int>*>* potentialPaths =
-      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, targetDFGNode, &paths);
-  bool success = false;
-  while (potentialPaths->size() != 0) {
-    map<CGRANode*, int>* currentPath = potentialPaths->front();
-    potentialPaths->pop_front();
-    assert(currentPath->size() != 0);
-    if (schedule(t_cgra, t_dfg, t_II, targetDFGNode, currentPath,
+      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, t_dfgNode, &paths);
+  vector<float> linkPressure = m_linkPressure;
+  map<CGRANode*, int>* scheduledPath = NULL;
+  int attempts = 0;
+  for (map<CGRANode*, int>* currentPath: *potentialPaths) {
+    if (attempts > m_rollbackCandidates or isCancelled())
+      break;
+    if (attempts > 0)
+      cout<<"[DEBUG] rollback and try candidate "<<attempts<<" for DFG node "<<t_dfgNode->getID()<<" II: "<<t_II<<"\n";
+    ++attempts;
+    m_isRollbackRecording = true;
+    if (schedule(t_cgra, t_dfg, t_II, t_dfgNode, currentPath,
         t_isStaticElasticCGRA)) {
-      t_exhaustivePaths->push_back(currentPath);
-      t_mappedDFGNodes->push_back(targetDFGNode);
-      success = DFSMap(t_cgra, t_dfg, t_II, t_mappedDFGNodes,
-          t_exhaustivePaths, t_isStaticElasticCGRA);
-      if (success)
-        return true;
-    }
-    // If the schedule fails and need to try the other schedule,
-    // should re-construct m_mapping and m_mappingTiming.
-    constructMRRG(t_dfg, t_cgra, t_II);
-    list<DFGNode*>::iterator mappedDFGNodeItr = t_mappedDFGNodes->begin();
-    for (map<CGRANode*, int>* path: *t_exhaustivePaths) {
-      if (!schedule(t_cgra, t_dfg, t_II, *mappedDFGNodeItr, path,
-          t_isStaticElasticCGRA)) {
-        cout<<"DEBUG <this is impossible> fail7 in DFS() II: "<<t_II<<"\n";
-        assert(0);
+      if (!m_forwardChecking or forwardCheck(t_II, t_dfgNode)) {
+        endRollbackRecording(false);
+        t_scheduledDFGNodes->push_back(t_dfgNode);
+        t_scheduledPaths->push_back(currentPath);
+        scheduledPath = currentPath;
         break;
       }
-      ++mappedDFGNodeItr;
+      cout<<"[DEBUG] forward checking fails for DFG node "<<t_dfgNode->getID()<<" II: "<<t_II<<"\n";
+    }
+    cout<<"[DEBUG] fail1 in schedule() II: "<<t_II<<"\n";
+    for (map<CGRANode*,int>::iterator iter = currentPath->begin();
+        iter!=currentPath->end(); ++iter) {
+      cout<<"[DEBUG] the failed path -- cycle: "<<(*iter).second<<" CGRANode: "<<(*iter).first->getID()<<"\n";
     }
+    endRollbackRecording(true);
+    m_mapping.erase(t_dfgNode);
+    m_mappingTiming.erase(t_dfgNode);
+    m_linkPressure = linkPressure;
+    resetRecurrenceTiming();
+    t_dfgNode->clearMapped();
   }
-  if (t_exhaustivePaths->size() != 0) {
-    cout<<"======= go backward one step ======== popped DFG node ["<<t_mappedDFGNodes->back()->getID()<<"] from CGRA node ["<<m_mapping[t_mappedDFGNodes->back()]->getID()<<"]\n";
-    t_mappedDFGNodes->pop_back();
-    t_exhaustivePaths->pop_back();
-//    m_exit++;
+  delete potentialPaths;
+  for (map<CGRANode*, int>* path: paths)
+    if (path != scheduledPath)
+      delete path;
+  return scheduledPath != NULL;
+}
+
+void Mapper::recordForRollback(CGRANode* t_cgraNode) {
+  if (m_isRollbackRecording and m_rollbackCGRANodes.insert(t_cgraNode).second)
+    t_cgraNode->recordMRRGChanges();
+}
+
+void Mapper::recordForRollback(CGRALink* t_cgraLink) {
+  if (!m_isRollbackRecording)
+    return;
+  recordForRollback(t_cgraLink->getDst());
+  if (m_rollbackCGRALinks.insert(t_cgraLink).second)
+    t_cgraLink->recordMRRGChanges();
+}
+
+void Mapper::endRollbackRecording(bool t_isUndone) {
+  for (CGRANode* cgraNode: m_rollbackCGRANodes) {
+    if (t_isUndone)
+      cgraNode->undoMRRGChanges();
+    else
+      cgraNode->keepMRRGChanges();
+  }
+  for (CGRALink* cgraLink: m_rollbackCGRALinks) {
+    if (t_isUndone)
+      cgraLink->undoMRRGChanges();
+    else
+      cgraLink->keepMRRGChanges();
+  }
+  m_rollbackCGRANodes.clear();
+  m_rollbackCGRALinks.clear();
+  m_isRollbackRecording = false;
+}
+
+/**
+ * what is in this function:
+ * 1. map t_dfgNode onto t_fu at t_cycle, schedule() routes the data of all its mapped neighbors to (and from) that slot.
+ * 2. undo the partial schedule with replaySchedule() if it fails.
+ */
+bool Mapper::scheduleOnSlot(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, CGRANode* t_fu, int t_cycle,
+    list<DFGNode*>* t_scheduledDFGNodes,
+    list<map<CGRANode*, int>*>* t_scheduledPaths,
+    bool t_isStaticElasticCGRA) {
+  if (!t_fu->canSupport(t_dfgNode) or !t_fu->canOccupy(t_dfgNode, t_cycle, t_II))
+    return false;
+  map<CGRANode*, int>* path = new map<CGRANode*, int>();
+  (*path)[t_fu] = t_cycle;
+  if (schedule(t_cgra, t_dfg, t_II, t_dfgNode, path, t_isStaticElasticCGRA) and
+      (!m_forwardChecking or forwardCheck(t_II, t_dfgNode))) {
+    t_scheduledDFGNodes->push_back(t_dfgNode);
+    t_scheduledPaths->push_back(path);
+    return true;
+  }
+  cout<<"[DEBUG] fail to schedule DFG node "<<t_dfgNode->getID()<<" onto fu["<<t_fu->getID()<<"] at cycle "<<t_cycle<<" II: "<<t_II<<"\n";
+  replaySchedule(t_cgra, t_dfg, t_II, t_scheduledDFGNodes,
+      t_scheduledPaths, t_isStaticElasticCGRA);
+  delete path;
+  return false;
+}
+
+/**
+ * what is in this function:
+ * 1. clean up the partial schedule left by the failed attempt with replaySchedule().
+ * 2. evict the DFGNodes on the forced FU slot (getEvictionVictims()), rebuild the rest with repairSchedule() and schedule t_dfgNode onto that slot (scheduleOnSlot()).
+ * 3. if it still fails, evict its mapped neighbors as well and force the next slot.
+ * 4. if both fail, repair the schedule without t_dfgNode.
+ */
+bool Mapper::scheduleByEviction(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, list<DFGNode*>* t_scheduledDFGNodes,
+    list<map<CGRANode*, int>*>* t_scheduledPaths,
+    map<DFGNode*, int>* t_lastForcedCycle, int* t_evictions,
+    bool t_isStaticElasticCGRA) {
+  bool placed = false;
+  for (int stage=0; stage<2 and !placed; ++stage) {
+    replaySchedule(t_cgra, t_dfg, t_II, t_scheduledDFGNodes,
+        t_scheduledPaths, t_isStaticElasticCGRA);
+    set<DFGNode*> victims;
+    int forcedCycle = 0;
+    CGRANode* forcedFU = getEvictionVictims(t_cgra, t_II, t_dfgNode,
+        stage>0, t_lastForcedCycle, &victims, &forcedCycle);
+    if (forcedFU == NULL)
+      continue;
+    list<DFGNode*>::iterator dfgNodeItr = t_scheduledDFGNodes->begin();
+    list<map<CGRANode*, int>*>::iterator pathItr = t_scheduledPaths->begin();
+    while (dfgNodeItr != t_scheduledDFGNodes->end()) {
+      if (victims.find(*dfgNodeItr) != victims.end()) {
+        cout<<"[DEBUG] IMS evict DFG node "<<(*dfgNodeItr)->getID()<<" for DFG node "<<t_dfgNode->getID()<<"\n";
+        dfgNodeItr = t_scheduledDFGNodes->erase(dfgNodeItr);
+        pathItr = t_scheduledPaths->erase(pathItr);
+        ++(*t_evictions);
+      } else {
+        ++dfgNodeItr;
+        ++pathItr;
+      }
+    }
+    *t_evictions += repairSchedule(t_cgra, t_dfg, t_II, t_scheduledDFGNodes,
+        t_scheduledPaths, t_isStaticElasticCGRA);
+    placed = scheduleOnSlot(t_cgra, t_dfg, t_II, t_dfgNode, forcedFU,
+        forcedCycle, t_scheduledDFGNodes, t_scheduledPaths,
+        t_isStaticElasticCGRA);
+  }
+  if (!placed)
+    *t_evictions += repairSchedule(t_cgra, t_dfg, t_II, t_scheduledDFGNodes,
+        t_scheduledPaths, t_isStaticElasticCGRA);
+  return placed;
+}
+
+/**
+ * what is in this function:
+ * 1. Try mapping when II is equal to certain value, the budget is m_imsBudgetRatio * the number of DFGNodes.
+ * 2. Always pick the first unscheduled DFGNode in the priority order (getPriorityOrder()), and try to schedule it with scheduleWithRollback().
+ * 3. If it cannot be placed, evict the DFGNodes in the way and schedule it onto the forced FU slot (scheduleByEviction()).
+ * 4. The evicted DFGNodes (and the ones whose routing depends on them) become unscheduled and will be picked again in priority order.
+ * 5. If the budget is used up, try the next II.
+ */
+int Mapper::iterativeModuloMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  bool fail = false;
+  while (1) {
+    cout<<"----------------------------------------\n";
+    cout<<"[DEBUG] start iterative modulo scheduling with II="<<t_II<<"\n";
+    constructMRRG(t_dfg, t_cgra, t_II);
+    fail = false;
+    list<DFGNode*> scheduledDFGNodes;
+    list<map<CGRANode*, int>*> scheduledPaths;
+    map<DFGNode*, int> lastForcedCycle;
+    int budget = m_imsBudgetRatio * t_dfg->getNodeCount();
+    int evictions = 0;
+    list<DFGNode*>* priorityOrder = getPriorityOrder(t_dfg);
+    while (1) {
+      DFGNode* targetDFGNode = NULL;
+      for (DFGNode* dfgNode: *priorityOrder) {
+        if (m_mapping.find(dfgNode) == m_mapping.end()) {
+          targetDFGNode = dfgNode;
+          break;
+        }
+      }
+      if (targetDFGNode == NULL)
+        break;
+      if (budget <= 0 or isCancelled()) {
+        fail = true;
+        break;
+      }
+      --budget;
+      if (scheduleWithRollback(t_cgra, t_dfg, t_II, targetDFGNode,
+          &scheduledDFGNodes, &scheduledPaths, t_isStaticElasticCGRA))
+        continue;
+      scheduleByEviction(t_cgra, t_dfg, t_II, targetDFGNode,
+          &scheduledDFGNodes, &scheduledPaths, &lastForcedCycle, &evictions,
+          t_isStaticElasticCGRA);
+    }
+    delete priorityOrder;
+    cout<<"[DEBUG] iterative modulo scheduling II="<<t_II<<" evictions: "<<evictions<<" remaining budget: "<<budget<<"\n";
+    if (!fail)
+      break;
+    else if (t_isStaticElasticCGRA or isCancelled() or
+             (m_maxII != -1 and t_II >= m_maxII)) {
+      break;
+    }
+    ++t_II;
+  }
+  if (!fail)
+    return t_II;
+  else
+    return -1;
+}
+
+/**
+ * what is in this function:
+ * 1. for each CGRANode supporting t_dfgNode, estimate the earliest cycle the data of the mapped predecessors can arrive there (one cycle per hop), and make it later than the last forced cycle.
+ * 2. count the mapped DFGNodes whose execution overlaps the modulo slot of that cycle on the CGRANode.
+ * 3. choose the CGRANode with the fewest conflicts (the distance to the mapped neighbors breaks the tie), its conflicting DFGNodes are the victims.
+ * 4. if t_evictNeighbors, also evict the mapped predecessors and successors.
+ */
+CGRANode* Mapper::getEvictionVictims(CGRA* t_cgra, int t_II,
+    DFGNode* t_dfgNode, bool t_evictNeighbors,
+    map<DFGNode*, int>* t_lastForcedCycle, set<DFGNode*>* t_victims,
+    int* t_forcedCycle) {
+  int lastForcedCycle = -1;
+  if (t_lastForcedCycle->find(t_dfgNode) != t_lastForcedCycle->end())
+    lastForcedCycle = (*t_lastForcedCycle)[t_dfgNode];
+
+  CGRANode* forcedFU = NULL;
+  list<DFGNode*> forcedConflicts;
+  int minConflicts = 0;
+  int minDistance = 0;
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<t_cgra->getColumns(); ++j) {
+      CGRANode* fu = t_cgra->nodes[i][j];
+      if (!fu->canSupport(t_dfgNode))
+        continue;
+      // The data through a back edge comes from the previous iteration.
+      int earliest = lastForcedCycle + 1;
+      for (DFGNode* pred: *(t_dfgNode->getPredNodes())) {
+        if (m_mapping.find(pred) == m_mapping.end())
+          continue;
+        int arrival = m_mappingTiming[pred] + pred->getExecLatency() +
+            t_cgra->getHopDistance(m_mapping[pred], fu);
+        if (isBackEdge(pred, t_dfgNode))
+          arrival -= t_II;
+        if (arrival > earliest)
+          earliest = arrival;
+      }
+      if (earliest >= m_maxMappingCycle)
+        continue;
+      list<DFGNode*> conflicts;
+      for (map<DFGNode*, CGRANode*>::iterator iter=m_mapping.begin();
+          iter!=m_mapping.end(); ++iter) {
+        if ((*iter).second != fu)
+          continue;
+        DFGNode* mappedDFGNode = (*iter).first;
+        bool overlapped = false;
+        for (int c=0; c<mappedDFGNode->getExecLatency() and !overlapped; ++c) {
+          for (int d=0; d<t_dfgNode->getExecLatency(); ++d) {
+            if ((m_mappingTiming[mappedDFGNode]+c)%t_II == (earliest+d)%t_II) {
+              overlapped = true;
+              break;
+            }
+          }
+        }
+        if (overlapped)
+          conflicts.push_back(mappedDFGNode);
+      }
+      int distance = 0;
+      for (DFGNode* pred: *(t_dfgNode->getPredNodes()))
+        if (m_mapping.find(pred) != m_mapping.end())
+          distance += t_cgra->getHopDistance(m_mapping[pred], fu);
+      for (DFGNode* succ: *(t_dfgNode->getSuccNodes()))
+        if (m_mapping.find(succ) != m_mapping.end())
+          distance += t_cgra->getHopDistance(fu, m_mapping[succ]);
+      if (forcedFU == NULL or (int)conflicts.size() < minConflicts or
+          ((int)conflicts.size() == minConflicts and distance < minDistance)) {
+        forcedFU = fu;
+        forcedConflicts = conflicts;
+        minConflicts = conflicts.size();
+        minDistance = distance;
+        *t_forcedCycle = earliest;
+      }
+    }
+  }
+  if (forcedFU == NULL)
+    return NULL;
+  (*t_lastForcedCycle)[t_dfgNode] = *t_forcedCycle;
+  cout<<"[DEBUG] IMS force DFG node "<<t_dfgNode->getID()<<" onto fu["<<forcedFU->getID()<<"] at cycle "<<*t_forcedCycle<<" with "<<minConflicts<<" conflicts\n";
+  for (DFGNode* conflict: forcedConflicts)
+    t_victims->insert(conflict);
+  if (t_evictNeighbors) {
+    for (DFGNode* pred: *(t_dfgNode->getPredNodes()))
+      if (m_mapping.find(pred) != m_mapping.end())
+        t_victims->insert(pred);
+    for (DFGNode* succ: *(t_dfgNode->getSuccNodes()))
+      if (m_mapping.find(succ) != m_mapping.end())
+        t_victims->insert(succ);
+  }
+  return forcedFU;
+}
+
+/**
+ * what is in this function:
+ * 1. construct the MRRG again.
+ * 2. traverse the recorded schedules in order, drop the record if its path cannot be reused (the target CGRANode is occupied or the source DFGNode of the path is gone).
+ * 3. schedule the other records, if one fails, drop it and start over from step 1.
+ */
+int Mapper::repairSchedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    list<DFGNode*>* t_scheduledDFGNodes,
+    list<map<CGRANode*, int>*>* t_scheduledPaths,
+    bool t_isStaticElasticCGRA) {
+  int dropped = 0;
+  bool clean = false;
+  while (!clean) {
+    constructMRRG(t_dfg, t_cgra, t_II);
+    clean = true;
+    list<DFGNode*>::iterator dfgNodeItr = t_scheduledDFGNodes->begin();
+    list<map<CGRANode*, int>*>::iterator pathItr = t_scheduledPaths->begin();
+    while (dfgNodeItr != t_scheduledDFGNodes->end()) {
+      map<int, CGRANode*>* reorderPath = getReorderPath(*pathItr);
+      CGRANode* fu = (*(reorderPath->rbegin())).second;
+      int fuCycle = (*(reorderPath->rbegin())).first;
+      CGRANode* srcCGRANode = (*(reorderPath->begin())).second;
+      int srcCycle = (*(reorderPath->begin())).first;
+      bool reusable = fu->canOccupy(*dfgNodeItr, fuCycle, t_II);
+      if (reusable and reorderPath->size() > 1) {
+        DFGNode* srcDFGNode = srcCGRANode->getMappedDFGNode(srcCycle);
+        reusable = (srcDFGNode != NULL and
+                    srcDFGNode->isPredecessorOf(*dfgNodeItr));
+      }
+      delete reorderPath;
+      bool scheduled = reusable and schedule(t_cgra, t_dfg, t_II,
+          *dfgNodeItr, *pathItr, t_isStaticElasticCGRA);
+      if (scheduled) {
+        ++dfgNodeItr;
+        ++pathItr;
+        continue;
+      }
+      cout<<"[DEBUG] drop the schedule of DFG node "<<(*dfgNodeItr)->getID()<<" in repair\n";
+      dfgNodeItr = t_scheduledDFGNodes->erase(dfgNodeItr);
+      pathItr = t_scheduledPaths->erase(pathItr);
+      ++dropped;
+      // The failed schedule() leaves partial routing in the MRRG.
+      if (reusable) {
+        clean = false;
+        break;
+      }
+    }
+  }
+  return dropped;
+}
+
+/**
+ * what is in this function:
+ * 1. Try mapping when II is equal to certain value, construct the MRRG and get the initial placement with placeUnmapped().
+ * 2. perturb the placement for m_annealingIterations times, the moved DFGNode is removed from its CGRANode and set onto the new one only if the new one can be occupied, so there is no modulo conflict in the MRRG.
+ * 3. only the DFGEdges connected to the moved DFGNode are evaluated again.
+ * 4. route the placement without timing violation with negotiatedRoute(), at most once per (the number of DFGNodes) perturbations.
+ * 5. if the iterations are used up, try the next II.
+ */
+int Mapper::annealingMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  // Only negotiatedRoute() can route the placement.
+  if (m_pathFinderIterations <= 0) {
+    cout<<"[DEBUG] simulated annealing needs pathFinderIterations > 0\n";
+    return -1;
+  }
+  mt19937 random(m_annealingSeed);
+  uniform_real_distribution<float> probability(0.0, 1.0);
+  map<DFGNode*, int> order;
+  vector<DFGNode*> dfgNodes;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    order[dfgNode] = dfgNodes.size();
+    dfgNodes.push_back(dfgNode);
+  }
+  vector<CGRANode*> fus;
+  for (int i=0; i<t_cgra->getRows(); ++i)
+    for (int j=0; j<t_cgra->getColumns(); ++j)
+      fus.push_back(t_cgra->nodes[i][j]);
+  int nodeCount = dfgNodes.size();
+
+  bool fail = false;
+  while (1) {
+    cout<<"----------------------------------------\n";
+    cout<<"[DEBUG] start simulated annealing with II="<<t_II<<"\n";
+    constructMRRG(t_dfg, t_cgra, t_II);
+    fail = true;
+    if (!placeUnmapped(t_cgra, t_dfg, t_II, false)) {
+      if (t_isStaticElasticCGRA or isCancelled() or
+          (m_maxII != -1 and t_II >= m_maxII))
+        break;
+      ++t_II;
+      continue;
+    }
+    int horizon = 0;
+    int totalViolation = 0;
+    for (DFGNode* dfgNode: dfgNodes) {
+      if (m_mappingTiming[dfgNode] + t_II > horizon)
+        horizon = m_mappingTiming[dfgNode] + t_II;
+      for (DFGNode* succ: *(dfgNode->getSuccNodes())) {
+        int violation = 0;
+        getPlacementCost(t_cgra, dfgNode, succ, t_II, order[succ] <= order[dfgNode],
+            &violation);
+        totalViolation += violation;
+      }
+    }
+
+    float temperature = m_annealingTemperature;
+    bool changed = true;
+    int lastRoute = -nodeCount;
+    for (int iteration=0; iteration<m_annealingIterations; ++iteration) {
+      if (isCancelled())
+        break;
+      if (totalViolation == 0 and changed and
+          iteration - lastRoute >= nodeCount) {
+        cout<<"[DEBUG] annealing tries to route the placement at iteration "<<iteration<<"\n";
+        lastRoute = iteration;
+        changed = false;
+        if (negotiatedRoute(t_cgra, t_dfg, t_II)) {
+          fail = false;
+          break;
+        }
+      }
+      if (iteration > 0 and iteration % nodeCount == 0)
+        temperature *= m_annealingCooling;
+
+      DFGNode* dfgNode = dfgNodes[random() % nodeCount];
+      CGRANode* oldFU = m_mapping[dfgNode];
+      int oldCycle = m_mappingTiming[dfgNode];
+      CGRANode* newFU = fus[random() % fus.size()];
+      int newCycle = oldCycle + (int)(random() % (2 * t_II + 1)) - t_II;
+      if (newCycle < 0 or newCycle >= horizon or
+          (newFU == oldFU and newCycle == oldCycle))
+        continue;
+      // Only the DFGEdges connected to the moved DFGNode are affected.
+      list<pair<DFGNode*, DFGNode*>> dfgEdges;
+      for (DFGNode* pred: *(dfgNode->getPredNodes()))
+        dfgEdges.push_back(make_pair(pred, dfgNode));
+      for (DFGNode* succ: *(dfgNode->getSuccNodes()))
+        if (succ != dfgNode)
+          dfgEdges.push_back(make_pair(dfgNode, succ));
+      int oldViolation = 0;
+      float oldCost = 0;
+      for (pair<DFGNode*, DFGNode*> dfgEdge: dfgEdges) {
+        int violation = 0;
+        oldCost += getPlacementCost(t_cgra, dfgEdge.first, dfgEdge.second, t_II,
+            order[dfgEdge.second] <= order[dfgEdge.first], &violation);
+        oldViolation += violation;
+      }
+      oldFU->removeDFGNode(dfgNode);
+      if (!newFU->canOccupy(dfgNode, newCycle, t_II)) {
+        oldFU->setDFGNode(dfgNode, oldCycle, t_II, t_isStaticElasticCGRA);
+        continue;
+      }
+      setMapping(dfgNode, newFU);
+      setMappingTiming(dfgNode, newCycle);
+      int newViolation = 0;
+      float newCost = 0;
+      for (pair<DFGNode*, DFGNode*> dfgEdge: dfgEdges) {
+        int violation = 0;
+        newCost += getPlacementCost(t_cgra, dfgEdge.first, dfgEdge.second, t_II,
+            order[dfgEdge.second] <= order[dfgEdge.first], &violation);
+        newViolation += violation;
+      }
+      float delta = newCost - oldCost;
+      if (delta <= 0 or probability(random) < exp(-delta / temperature)) {
+        newFU->setDFGNode(dfgNode, newCycle, t_II, t_isStaticElasticCGRA);
+        totalViolation += newViolation - oldViolation;
+        changed = true;
+      } else {
+        setMapping(dfgNode, oldFU);
+        setMappingTiming(dfgNode, oldCycle);
+        oldFU->setDFGNode(dfgNode, oldCycle, t_II, t_isStaticElasticCGRA);
+      }
+    }
+    cout<<"[DEBUG] simulated annealing II="<<t_II<<" timing violation: "<<totalViolation<<" temperature: "<<temperature<<"\n";
+    if (!fail)
+      break;
+    else if (t_isStaticElasticCGRA or isCancelled() or
+             (m_maxII != -1 and t_II >= m_maxII)) {
+      break;
+    }
+    ++t_II;
+  }
+  if (!fail)
+    return t_II;
+  else
+    return -1;
+}
+
+float Mapper::getPlacementCost(CGRA* t_cgra, DFGNode* t_srcDFGNode,
+    DFGNode* t_dstDFGNode, int t_II, bool t_isBackward, int* t_violation) {
+  int hops = t_cgra->getHopDistance(m_mapping[t_srcDFGNode],
+                                    m_mapping[t_dstDFGNode]);
+  int departure = m_mappingTiming[t_srcDFGNode] + t_srcDFGNode->getExecLatency() - 1;
+  int deadline = m_mappingTiming[t_dstDFGNode];
+  *t_violation = 0;
+  if (t_isBackward) {
+    // The backward data is consumed in the next iteration, but the
+    // destination should not start after the source finishes, otherwise
+    // the data is consumed in the same iteration.
+    if (deadline > departure)
+      *t_violation += deadline - departure;
+    deadline += t_II;
+  }
+  int slack = deadline - departure - (hops > 0 ? hops : 1);
+  if (slack < 0)
+    *t_violation -= slack;
+  float cost = hops + 10 * (*t_violation);
+  if (slack > 0)
+    cost += 0.05 * slack;
+  return cost;
+}
+
+/**
+ * what is in this function:
+ * 1. make sure the lazily built predecessor and successor lists of the shared DFG are ready before the threads start.
+ * 2. for each II, clone the CGRA and copy this Mapper for every strategy, they share one cancellation token and only try this II.
+ * 3. run the strategies in threads, the first one succeeding sets the token, so the others stop in their search and routing loops.
+ * 4. copy the MRRG and the mapping of the winner back, or try the next II if all of them fail.
+ */
+int Mapper::portfolioMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->getPredNodes();
+    dfgNode->getSuccNodes();
+  }
+  const int strategyCount = 3;
+  string strategyNames[strategyCount] = {"heuristic", "randomized heuristic",
+                                         "bounded exhaustive"};
+  while (1) {
+    cout<<"----------------------------------------\n";
+    cout<<"[DEBUG] start portfolio with II="<<t_II<<"\n";
+    atomic<bool> cancelToken(false);
+    atomic<int> winner(-1);
+    CGRA* cgras[strategyCount];
+    Mapper* mappers[strategyCount];
+    for (int s=0; s<strategyCount; ++s) {
+      cgras[s] = t_cgra->clone();
+      mappers[s] = new Mapper(*this);
+      mappers[s]->m_cancelToken = &cancelToken;
+      mappers[s]->m_cancelParent = this;
+      mappers[s]->m_maxII = t_II;
+    }
+    mappers[1]->setRandomSeed((m_randomSeed == -1 ? 0 : m_randomSeed) + t_II);
+    if (m_dfsExpansionBudget == 0)
+      mappers[2]->setDFSExpansionBudget(8 * t_dfg->getNodeCount());
+    mappers[2]->setDFSThreads(1);
+    mappers[2]->setParallelIIs(1);
+
+    vector<thread> workers;
+    for (int s=0; s<strategyCount; ++s) {
+      workers.push_back(thread([&, s]() {
+        int II = -1;
+        if (s == 2)
+          II = mappers[s]->exhaustiveMap(cgras[s], t_dfg, t_II,
+                                         t_isStaticElasticCGRA);
+        else
+          II = mappers[s]->heuristicMap(cgras[s], t_dfg, t_II,
+                                        t_isStaticElasticCGRA);
+        int none = -1;
+        if (II != -1 and winner.compare_exchange_strong(none, s))
+          cancelToken = true;
+      }));
+    }
+    for (thread& worker: workers)
+      worker.join();
+
+    int winnerStrategy = winner.load();
+    if (winnerStrategy != -1) {
+      cout<<"[DEBUG] portfolio strategy "<<strategyNames[winnerStrategy]<<" wins with II="<<t_II<<"\n";
+      t_cgra->copyMRRGFrom(cgras[winnerStrategy]);
+      copyMappingFrom(mappers[winnerStrategy], t_cgra);
+    }
+    for (int s=0; s<strategyCount; ++s) {
+      delete mappers[s];
+      delete cgras[s];
+    }
+    if (winnerStrategy != -1)
+      return t_II;
+    if (t_isStaticElasticCGRA or (m_maxII != -1 and t_II >= m_maxII))
+      return -1;
+    ++t_II;
+  }
+}
+
+/**
+ * what is in this function:
+ * 1. Try mapping when II is equal to certain value, clone the CGRA and copy this Mapper for each variant.
+ * 2. The first variant uses the seed of this Mapper, the others use the following seeds.
+ * 3. Run heuristicMap of the variants in threads, all of them only try the current II.
+ * 4. copy the MRRG and the mapping of the first successful variant back, or try the next II if all of them fail.
+ */
+int Mapper::multiStartMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->getPredNodes();
+    dfgNode->getSuccNodes();
+  }
+  int variantCount = m_multiStartCount < 1 ? 1 : m_multiStartCount;
+  m_winningSeed = -1;
+  while (1) {
+    cout<<"----------------------------------------\n";
+    cout<<"[DEBUG] start multi-start heuristic with II="<<t_II<<"\n";
+    vector<CGRA*> cgras;
+    vector<Mapper*> mappers;
+    vector<int> seeds;
+    vector<int> results(variantCount, -1);
+    for (int v=0; v<variantCount; ++v) {
+      cgras.push_back(t_cgra->clone());
+      mappers.push_back(new Mapper(*this));
+      mappers[v]->m_maxII = t_II;
+      if (m_randomSeed == -1)
+        seeds.push_back(v == 0 ? -1 : v);
+      else
+        seeds.push_back(m_randomSeed + v);
+      mappers[v]->setRandomSeed(seeds[v]);
+    }
+
+    vector<thread> workers;
+    for (int v=0; v<variantCount; ++v) {
+      workers.push_back(thread([&, v]() {
+        results[v] = mappers[v]->heuristicMap(cgras[v], t_dfg, t_II,
+                                              t_isStaticElasticCGRA);
+      }));
+    }
+    for (thread& worker: workers)
+      worker.join();
+
+    // Pick the first successful variant, so that the result only depends
+    // on the seeds.
+    int winner = -1;
+    for (int v=0; v<variantCount; ++v) {
+      if (results[v] != -1) {
+        winner = v;
+        break;
+      }
+    }
+    if (winner != -1) {
+      m_winningSeed = seeds[winner];
+      cout<<"[DEBUG] multi-start seed "<<m_winningSeed<<" wins with II="<<t_II<<"\n";
+      t_cgra->copyMRRGFrom(cgras[winner]);
+      copyMappingFrom(mappers[winner], t_cgra);
+    }
+    for (int v=0; v<variantCount; ++v) {
+      delete mappers[v];
+      delete cgras[v];
+    }
+    if (winner != -1)
+      return t_II;
+    if (t_isStaticElasticCGRA or isCancelled() or
+        (m_maxII != -1 and t_II >= m_maxII))
+      return -1;
+    ++t_II;
+  }
+}
+
+/**
+ * what is in this function:
+ * 1. Start from the empty partial mapping, the beam only records the paths of the partial mappings in schedule order.
+ * 2. For each DFGNode in the mapping order, rebuild every partial mapping in the beam with replaySchedule(), and snapshot the MRRG.
+ * 3. Try to schedule the m_beamWidth cheapest paths on it, rank each successful extension, and restore the MRRG from the snapshot.
+ * 4. Keep the m_beamWidth extensions with the lowest rank. If none is left, try the next II.
+ * 5. Rebuild the best partial mapping once all the DFGNodes are scheduled.
+ */
+int Mapper::beamSearchMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  CGRA* snapshot = t_cgra->clone();
+  int beamWidth = m_beamWidth < 1 ? 1 : m_beamWidth;
+  bool fail = false;
+  while (1) {
+    cout<<"----------------------------------------\n";
+    cout<<"[DEBUG] start beam search with II="<<t_II<<" width="<<beamWidth<<"\n";
+    constructMRRG(t_dfg, t_cgra, t_II);
+    fail = false;
+    list<DFGNode*>* mappingOrder = getMappingOrder(t_dfg);
+    list<DFGNode*> scheduledDFGNodes;
+    vector<list<map<CGRANode*, int>*>*> beam;
+    vector<float> beamCosts;
+    beam.push_back(new list<map<CGRANode*, int>*>());
+    beamCosts.push_back(0.0);
+    for (DFGNode* dfgNode: *mappingOrder) {
+      // The extensions ordered by rank, each one is the accumulated cost
+      // and the paths.
+      multimap<float, pair<float, list<map<CGRANode*, int>*>*>> extensions;
+      for (int b=0; b<(int)beam.size() and !isCancelled(); ++b) {
+        if (!replaySchedule(t_cgra, t_dfg, t_II, &scheduledDFGNodes, beam[b],
+            t_isStaticElasticCGRA))
+          continue;
+        snapshot->copyMRRGFrom(t_cgra);
+        map<DFGNode*, CGRANode*> mapping = m_mapping;
+        map<DFGNode*, int> mappingTiming = m_mappingTiming;
+        vector<float> linkPressure = m_linkPressure;
+
+        list<map<CGRANode*, int>*> paths;
+        for (int i=0; i<t_cgra->getRows(); ++i) {
+          for (int j=0; j<t_cgra->getColumns(); ++j) {
+            map<CGRANode*, int>* tempPath = calculateCost(t_cgra, t_dfg, t_II,
+                dfgNode, t_cgra->nodes[i][j]);
+            if (tempPath != NULL and tempPath->size() != 0)
+              paths.push_back(tempPath);
+          }
+        }
+        list<map<CGRANode*, int>*>* potentialPaths =
+            getOrderedPotentialPaths(t_cgra, t_dfg, t_II, dfgNode, &paths);
+        int attempts = 0;
+        for (map<CGRANode*, int>* path: *potentialPaths) {
+          if (attempts == beamWidth)
+            break;
+          ++attempts;
+          float cost = beamCosts[b] + getPathCost(t_cgra, t_dfg, t_II,
+                                                  dfgNode, path);
+          if (schedule(t_cgra, t_dfg, t_II, dfgNode, path,
+              t_isStaticElasticCGRA)) {
+            float rank = cost - getFreeLinkSlots(t_cgra, t_II) * m_freeLinkBonus;
+            list<map<CGRANode*, int>*>* extension =
+                new list<map<CGRANode*, int>*>(*beam[b]);
+            extension->push_back(path);
+            extensions.insert(make_pair(rank, make_pair(cost, extension)));
+          }
+          // Restore the partial mapping for the next path.
+          t_cgra->copyMRRGFrom(snapshot);
+          m_mapping = mapping;
+          m_mappingTiming = mappingTiming;
+          m_linkPressure = linkPressure;
+          resetRecurrenceTiming();
+        }
+        delete potentialPaths;
+      }
+      for (list<map<CGRANode*, int>*>* partialMapping: beam)
+        delete partialMapping;
+      beam.clear();
+      beamCosts.clear();
+      for (pair<float, pair<float, list<map<CGRANode*, int>*>*>> extension:
+          extensions) {
+        if ((int)beam.size() < beamWidth) {
+          beam.push_back(extension.second.second);
+          beamCosts.push_back(extension.second.first);
+        } else {
+          delete extension.second.second;
+        }
+      }
+      if (beam.size() == 0 or isCancelled()) {
+        cout<<"[DEBUG] beam is empty at DFG node "<<dfgNode->getID()<<" II: "<<t_II<<"\n";
+        fail = true;
+        break;
+      }
+      scheduledDFGNodes.push_back(dfgNode);
+      cout<<"[DEBUG] beam keeps "<<beam.size()<<" partial mappings after DFG node "<<dfgNode->getID()<<"\n";
+    }
+    if (!fail) {
+      cout<<"[DEBUG] beam search succeeds with cost "<<beamCosts[0]<<"\n";
+      replaySchedule(t_cgra, t_dfg, t_II, &scheduledDFGNodes, beam[0],
+                     t_isStaticElasticCGRA);
+    }
+    for (list<map<CGRANode*, int>*>* partialMapping: beam)
+      delete partialMapping;
+    delete mappingOrder;
+    if (!fail)
+      break;
+    else if (t_isStaticElasticCGRA or isCancelled() or
+             (m_maxII != -1 and t_II >= m_maxII)) {
+      break;
+    }
+    ++t_II;
+  }
+  delete snapshot;
+  if (!fail)
+    return t_II;
+  else
+    return -1;
+}
+
+int Mapper::getFreeLinkSlots(CGRA* t_cgra, int t_II) {
+  int freeSlots = 0;
+  for (int i=0; i<t_cgra->getLinkCount(); ++i)
+    for (int cycle=0; cycle<t_II; ++cycle)
+      if (!t_cgra->links[i]->isDisabled() and
+          !t_cgra->links[i]->isOccupied(cycle))
+        ++freeSlots;
+  return freeSlots;
+}
+
+/**
+ * what is in this function:
+ * 1. Find the symmetries of the CGRA once.
+ * 2. Search the current II with searchExhaustively(), or the next m_parallelIIs IIs in parallel threads.
+ * 3. If it fails, try the next II (or the next batch of IIs) until m_maxII.
+ */
+int Mapper::exhaustiveMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  m_symmetries.clear();
+  m_linkSymmetries.clear();
+  if (m_dfsSymmetryBreaking)
+    findSymmetries(t_cgra, t_dfg);
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->getPredNodes();
+    dfgNode->getSuccNodes();
+  }
+  list<DFGNode*>* priorityOrder = getPriorityOrder(t_dfg);
+  m_dfsOrder.assign(priorityOrder->begin(), priorityOrder->end());
+  delete priorityOrder;
+  while (1) {
+    int batch = m_parallelIIs < 1 ? 1 : m_parallelIIs;
+    if (m_maxII != -1 and t_II + batch - 1 > m_maxII)
+      batch = m_maxII - t_II + 1;
+    if (batch <= 1) {
+      if (searchExhaustively(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA))
+        return t_II;
+    } else {
+      // Once an II succeeds, the larger IIs are cancelled.
+      atomic<bool>* cancelTokens = new atomic<bool>[batch];
+      vector<CGRA*> cgras;
+      vector<Mapper*> mappers;
+      // vector<bool> packs the bits, the threads cannot write it at once.
+      vector<char> results(batch, false);
+      for (int b=0; b<batch; ++b) {
+        cancelTokens[b] = false;
+        cgras.push_back(t_cgra->clone());
+        mappers.push_back(new Mapper(*this));
+        mappers[b]->m_cancelToken = &cancelTokens[b];
+        mappers[b]->m_cancelParent = this;
+      }
+      vector<thread> workers;
+      for (int b=0; b<batch; ++b) {
+        workers.push_back(thread([&, b]() {
+          results[b] = mappers[b]->searchExhaustively(cgras[b], t_dfg,
+              t_II + b, t_isStaticElasticCGRA);
+          if (results[b])
+            for (int larger=b+1; larger<batch; ++larger)
+              cancelTokens[larger] = true;
+        }));
+      }
+      for (thread& worker: workers)
+        worker.join();
+      int winner = -1;
+      for (int b=0; b<batch and winner == -1; ++b)
+        if (results[b])
+          winner = b;
+      if (winner != -1) {
+        t_cgra->copyMRRGFrom(cgras[winner]);
+        copyMappingFrom(mappers[winner], t_cgra);
+      }
+      for (int b=0; b<batch; ++b) {
+        delete mappers[b];
+        delete cgras[b];
+      }
+      delete[] cancelTokens;
+      if (winner != -1)
+        return t_II + winner;
+      t_II += batch - 1;
+    }
+    if (isCancelled() or (m_maxII != -1 and t_II >= m_maxII))
+      return -1;
+    ++t_II;
+  }
+}
+
+bool Mapper::searchExhaustively(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  cout<<"----------------------------------------\n";
+  cout<<"[DEBUG] start exhaustive search with II="<<t_II<<"\n";
+  list<map<CGRANode*, int>*>* exhaustivePaths = new list<map<CGRANode*, int>*>();
+  list<DFGNode*>* mappedDFGNodes = new list<DFGNode*>();
+  m_dfsExpansions = 0;
+  m_dfsPrunings = 0;
+  m_dfsNogoods.clear();
+  m_dfsNogoodHits = 0;
+  m_dfsSymmetryPrunings = 0;
+  m_dfsForwardCheckRejections = 0;
+  m_dfsDeadline = chrono::steady_clock::now() + chrono::seconds(m_dfsTimeBudget);
+  bool success = false;
+  if (m_dfsThreads > 1)
+    success = parallelDFSMap(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA);
+  else
+    success = DFSMap(t_cgra, t_dfg, t_II, mappedDFGNodes,
+        exhaustivePaths, t_isStaticElasticCGRA);
+  cout<<"[DEBUG] DFS with II="<<t_II<<" expansions: "<<m_dfsExpansions<<", prunings: "<<m_dfsPrunings<<", forward-check rejections: "<<m_dfsForwardCheckRejections<<", nogoods: "<<m_dfsNogoods.size()<<", nogood hits: "<<m_dfsNogoodHits<<", symmetries: "<<m_symmetries.size()+1<<", symmetric candidates skipped: "<<m_dfsSymmetryPrunings<<"\n";
+  delete mappedDFGNodes;
+  delete exhaustivePaths;
+  return success;
+}
+
+/**
+ * what is in this function:
+ * 1. expand the schedule prefixes level by level in the order of DFSMap (including the pruning and the symmetry breaking), until there are 4 subproblems for each worker or 3 levels are expanded.
+ * 2. deal the subproblems to the deques of the workers, each worker has a clone of the CGRA and a copy of this Mapper.
+ * 3. each worker runs DFSMap on its subproblems, taking them from the front of its own deque, and stealing them from the back of the others'.
+ * 4. copy the MRRG and the mapping of the worker that succeeds first back.
+ */
+bool Mapper::parallelDFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->getPredNodes();
+    dfgNode->getSuccNodes();
+  }
+  typedef pair<list<DFGNode*>, list<map<CGRANode*, int>*>> Prefix;
+  vector<Prefix> prefixes(1);
+  // The prefixes share the paths, they are freed after the search.
+  list<map<CGRANode*, int>*> expandedPaths;
+  int depth = 0;
+  while ((int)prefixes.size() < 4 * m_dfsThreads and depth < 3 and
+         depth + 1 < t_dfg->getNodeCount() and !isSearchStopped()) {
+    vector<Prefix> nextPrefixes;
+    for (Prefix& prefix: prefixes) {
+      replaySchedule(t_cgra, t_dfg, t_II, &prefix.first, &prefix.second,
+                     t_isStaticElasticCGRA);
+      DFGNode* targetDFGNode = getNextDFSNode(t_cgra, t_dfg, t_II,
+                                              &prefix.first);
+      list<map<CGRANode*, int>*> paths;
+      for (int i=0; i<t_cgra->getRows(); ++i) {
+        for (int j=0; j<t_cgra->getColumns(); ++j) {
+          map<CGRANode*, int>* tempPath = calculateCost(t_cgra, t_dfg, t_II,
+              targetDFGNode, t_cgra->nodes[i][j]);
+          if (tempPath != NULL and tempPath->size() != 0)
+            paths.push_back(tempPath);
+          else
+            delete tempPath;
+        }
+      }
+      expandedPaths.insert(expandedPaths.end(), paths.begin(), paths.end());
+      list<map<CGRANode*, int>*>* potentialPaths =
+          getOrderedPotentialPaths(t_cgra, t_dfg, t_II, targetDFGNode, &paths);
+      list<int> activeSymmetries;
+      if (m_symmetries.size() != 0)
+        activeSymmetries = getActiveSymmetries(t_cgra, t_II);
+      for (map<CGRANode*, int>* path: *potentialPaths) {
+        map<int, CGRANode*>* reorderPath = getReorderPath(path);
+        CGRANode* fu = (*reorderPath->rbegin()).second;
+        delete reorderPath;
+        int index = fu->getY() * t_cgra->getColumns() + fu->getX();
+        bool isSymmetric = false;
+        for (int symmetry: activeSymmetries)
+          if (m_symmetries[symmetry][index] < index)
+            isSymmetric = true;
+        if (isSymmetric) {
+          ++m_dfsSymmetryPrunings;
+          continue;
+        }
+        ++m_dfsExpansions;
+        if (schedule(t_cgra, t_dfg, t_II, targetDFGNode, path,
+            t_isStaticElasticCGRA)) {
+          if (m_forwardChecking and
+              !forwardCheck(t_II, targetDFGNode)) {
+            ++m_dfsForwardCheckRejections;
+          } else if (violatesLowerBounds(t_cgra, t_dfg, t_II)) {
+            ++m_dfsPrunings;
+          } else {
+            nextPrefixes.push_back(prefix);
+            nextPrefixes.back().first.push_back(targetDFGNode);
+            nextPrefixes.back().second.push_back(path);
+          }
+        }
+        replaySchedule(t_cgra, t_dfg, t_II, &prefix.first, &prefix.second,
+                       t_isStaticElasticCGRA);
+      }
+      delete potentialPaths;
+    }
+    prefixes = nextPrefixes;
+    if (prefixes.size() == 0) {
+      for (map<CGRANode*, int>* path: expandedPaths)
+        delete path;
+      return false;
+    }
+    ++depth;
+  }
+  cout<<"[DEBUG] parallel DFS with "<<m_dfsThreads<<" workers on "<<prefixes.size()<<" subproblems of depth "<<depth<<"\n";
+
+  atomic<bool> cancelToken(false);
+  atomic<int> winner(-1);
+  vector<CGRA*> cgras;
+  vector<Mapper*> mappers;
+  vector<deque<Prefix*>> deques(m_dfsThreads);
+  vector<mutex> locks(m_dfsThreads);
+  for (int w=0; w<m_dfsThreads; ++w) {
+    cgras.push_back(t_cgra->clone());
+    mappers.push_back(new Mapper(*this));
+    mappers[w]->m_cancelToken = &cancelToken;
+    mappers[w]->m_cancelParent = this;
+    mappers[w]->m_dfsExpansions = 0;
+    mappers[w]->m_dfsPrunings = 0;
+    mappers[w]->m_dfsNogoodHits = 0;
+    mappers[w]->m_dfsSymmetryPrunings = 0;
+    mappers[w]->m_dfsForwardCheckRejections = 0;
+  }
+  for (int p=0; p<(int)prefixes.size(); ++p)
+    deques[p % m_dfsThreads].push_back(&prefixes[p]);
+
+  vector<thread> workers;
+  for (int w=0; w<m_dfsThreads; ++w) {
+    workers.push_back(thread([&, w]() {
+      Mapper* mapper = mappers[w];
+      CGRA* cgra = cgras[w];
+      while (!mapper->isSearchStopped()) {
+        Prefix* prefix = NULL;
+        locks[w].lock();
+        if (deques[w].size() != 0) {
+          prefix = deques[w].front();
+          deques[w].pop_front();
+        }
+        locks[w].unlock();
+        for (int v=(w+1)%m_dfsThreads; prefix == NULL and v != w;
+            v=(v+1)%m_dfsThreads) {
+          locks[v].lock();
+          if (deques[v].size() != 0) {
+            prefix = deques[v].back();
+            deques[v].pop_back();
+          }
+          locks[v].unlock();
+        }
+        if (prefix == NULL)
+          break;
+        // The paths refer to the CGRANodes of t_cgra, translate them to
+        // the clone of this worker.
+        list<DFGNode*> mappedDFGNodes(prefix->first);
+        list<map<CGRANode*, int>*> clonedPaths;
+        for (map<CGRANode*, int>* path: prefix->second) {
+          map<CGRANode*, int>* clonedPath = new map<CGRANode*, int>();
+          for (pair<CGRANode*, int> p: *path)
+            (*clonedPath)[cgra->nodes[p.first->getY()][p.first->getX()]] = p.second;
+          clonedPaths.push_back(clonedPath);
+        }
+        list<map<CGRANode*, int>*> exhaustivePaths(clonedPaths);
+        bool success = mapper->DFSMap(cgra, t_dfg, t_II, &mappedDFGNodes,
+            &exhaustivePaths, t_isStaticElasticCGRA);
+        // The MRRG keeps the schedule, the cloned paths are not needed any
+        // more.
+        for (map<CGRANode*, int>* clonedPath: clonedPaths)
+          delete clonedPath;
+        if (success) {
+          int none = -1;
+          if (winner.compare_exchange_strong(none, w))
+            cancelToken = true;
+          break;
+        }
+      }
+    }));
+  }
+  for (thread& worker: workers)
+    worker.join();
+
+  int winnerWorker = winner.load();
+  if (winnerWorker != -1) {
+    t_cgra->copyMRRGFrom(cgras[winnerWorker]);
+    copyMappingFrom(mappers[winnerWorker], t_cgra);
+  }
+  for (int w=0; w<m_dfsThreads; ++w) {
+    m_dfsExpansions += mappers[w]->m_dfsExpansions;
+    m_dfsPrunings += mappers[w]->m_dfsPrunings;
+    m_dfsNogoodHits += mappers[w]->m_dfsNogoodHits;
+    m_dfsSymmetryPrunings += mappers[w]->m_dfsSymmetryPrunings;
+    m_dfsForwardCheckRejections += mappers[w]->m_dfsForwardCheckRejections;
+    m_dfsNogoods.insert(mappers[w]->m_dfsNogoods.begin(),
+                        mappers[w]->m_dfsNogoods.end());
+    delete mappers[w];
+    delete cgras[w];
+  }
+  for (map<CGRANode*, int>* path: expandedPaths)
+    delete path;
+  return winnerWorker != -1;
+}
+
+bool Mapper::DFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    list<DFGNode*>* t_mappedDFGNodes,
+    list<map<CGRANode*, int>*>* t_exhaustivePaths,
+    bool t_isStaticElasticCGRA) {
+//  , DFGNode* t_badMappedDFGNode) {
+
+//  list<map<CGRANode*, int>*>* exhaustivePaths = t_exhaustivePaths;
+
+//  list<DFGNode*> dfgNodeSearchPool;
+//  for (list<DFGNode*>::iterator dfgNodeItr=dfg->nodes.begin();
+//      dfgNodeItr!=dfg->nodes.end(); ++dfgNodeItr) {
+//    dfgNodeSearchPool.push_back(*dfgNodeItr);
+//  }
+
+  // Give up the search once it is cancelled or out of the budget.
+  if (isSearchStopped()) {
+    if (t_exhaustivePaths->size() != 0) {
+      t_mappedDFGNodes->pop_back();
+      t_exhaustivePaths->pop_back();
+    }
+    return false;
+  }
+
+//  list<DFGNode*>::iterator dfgNodeItr = t_dfg->getDFSOrderedNodes()->begin();
+  if (!replaySchedule(t_cgra, t_dfg, t_II, t_mappedDFGNodes,
+      t_exhaustivePaths, t_isStaticElasticCGRA) and !isCancelled()) {
+    cout<<"DEBUG <this is impossible> fail3 in DFS() II: "<<t_II<<"\n";
+    assert(0);
+  }
+//  if (dfgNodeSearchPool.size() == 0) {
+  DFGNode* targetDFGNode = getNextDFSNode(t_cgra, t_dfg, t_II,
+                                          t_mappedDFGNodes);
+  if (targetDFGNode == NULL)
+    return true;
+//  }
+
+  list<map<CGRANode*, int>*> paths;
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<t_cgra->getColumns(); ++j) {
+      CGRANode* fu = t_cgra->nodes[i][j];
+      map<CGRANode*, int>* tempPath =
+          calculateCost(t_cgra, t_dfg, t_II, targetDFGNode, fu);
+      if(tempPath != NULL and tempPath->size() != 0) {
+        paths.push_back(tempPath);
+      }
+    }
+  }
+
+  list<map<CGRANode*, int>*>* potentialPaths =
+      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, targetDFGNode, &paths);
+  list<int> activeSymmetries;
+  if (m_symmetries.size() != 0)
+    activeSymmetries = getActiveSymmetries(t_cgra, t_II);
+  bool success = false;
+  while (potentialPaths->size() != 0 and !isSearchStopped()) {
+    map<CGRANode*, int>* currentPath = potentialPaths->front();
+    potentialPaths->pop_front();
+    assert(currentPath->size() != 0);
+    // Only explore the CGRANode with the smallest index among its
+    // symmetric images, while the partial mapping is symmetric.
+    if (activeSymmetries.size() != 0) {
+      map<int, CGRANode*>* reorderPath = getReorderPath(currentPath);
+      CGRANode* fu = (*reorderPath->rbegin()).second;
+      delete reorderPath;
+      int index = fu->getY() * t_cgra->getColumns() + fu->getX();
+      bool isSymmetric = false;
+      for (int symmetry: activeSymmetries)
+        if (m_symmetries[symmetry][index] < index)
+          isSymmetric = true;
+      if (isSymmetric) {
+        ++m_dfsSymmetryPrunings;
+        continue;
+      }
+    }
+    // Skip the candidate that failed in schedule() with the same
+    // neighbors before.
+    vector<int> signature;
+    if (m_dfsNogoodLearning) {
+      signature = getNogoodSignature(t_II, targetDFGNode, currentPath);
+      if (m_dfsNogoods.find(signature) != m_dfsNogoods.end()) {
+        ++m_dfsNogoodHits;
+        continue;
+      }
+    }
+    ++m_dfsExpansions;
+    if (schedule(t_cgra, t_dfg, t_II, targetDFGNode, currentPath,
+        t_isStaticElasticCGRA)) {
+      // Prune the subtree that cannot succeed.
+      if (m_forwardChecking and
+          !forwardCheck(t_II, targetDFGNode)) {
+        ++m_dfsForwardCheckRejections;
+      } else if (violatesLowerBounds(t_cgra, t_dfg, t_II)) {
+        ++m_dfsPrunings;
+      } else {
+        t_exhaustivePaths->push_back(currentPath);
+        t_mappedDFGNodes->push_back(targetDFGNode);
+        success = DFSMap(t_cgra, t_dfg, t_II, t_mappedDFGNodes,
+            t_exhaustivePaths, t_isStaticElasticCGRA);
+        if (success)
+          return true;
+      }
+    } else if (m_dfsNogoodLearning and !isCancelled()) {
+      m_dfsNogoods.insert(signature);
+    }
+    // If the schedule fails and need to try the other schedule,
+    // should re-construct m_mapping and m_mappingTiming.
+    if (!replaySchedule(t_cgra, t_dfg, t_II, t_mappedDFGNodes,
+        t_exhaustivePaths, t_isStaticElasticCGRA) and !isCancelled()) {
+      cout<<"DEBUG <this is impossible> fail7 in DFS() II: "<<t_II<<"\n";
+      assert(0);
+    }
+  }
+  if (t_exhaustivePaths->size() != 0) {
+    // The MRRG is not replayed completely once the search is cancelled.
+    if (!isCancelled())
+      cout<<"======= go backward one step ======== popped DFG node ["<<t_mappedDFGNodes->back()->getID()<<"] from CGRA node ["<<m_mapping[t_mappedDFGNodes->back()]->getID()<<"]\n";
+    t_mappedDFGNodes->pop_back();
+    t_exhaustivePaths->pop_back();
+//    m_exit++;
 //    if (m_exit == 2)
 //      exit(0);
   }
@@ -1340,6 +3962,329 @@ bool Mapper::DFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
   return false;
 }
 
+/**
+ * what is in this function:
+ * 1. count the free FU slots of each CGRANode within II, and group the unmapped DFGNodes by the CGRANodes supporting them.
+ * 2. compare the DFGNodes that can only use a group of CGRANodes with the free FU slots of the group.
+ * 3. propagate the earliest cycle along the forward DFGEdges, and compare it with the maximum mapping cycle.
+ * 4. sum the time around each recurrence cycle and compare it with II.
+ */
+bool Mapper::violatesLowerBounds(CGRA* t_cgra, DFG* t_dfg, int t_II) {
+  int cgraNodeCount = t_cgra->getRows() * t_cgra->getColumns();
+  vector<int> freeSlots(cgraNodeCount, 0);
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<t_cgra->getColumns(); ++j) {
+      for (int cycle=0; cycle<t_II; ++cycle) {
+        if (!t_cgra->nodes[i][j]->isOccupied(cycle, t_II))
+          ++freeSlots[i*t_cgra->getColumns()+j];
+      }
+    }
+  }
+  map<vector<bool>, int> supportCount;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    if (m_mapping.find(dfgNode) != m_mapping.end())
+      continue;
+    vector<bool> support(cgraNodeCount, false);
+    for (int i=0; i<t_cgra->getRows(); ++i)
+      for (int j=0; j<t_cgra->getColumns(); ++j)
+        support[i*t_cgra->getColumns()+j] =
+            t_cgra->nodes[i][j]->canSupport(dfgNode);
+    ++supportCount[support];
+  }
+  for (pair<vector<bool>, int> group: supportCount) {
+    int free = 0;
+    for (int k=0; k<cgraNodeCount; ++k)
+      if (group.first[k])
+        free += freeSlots[k];
+    int demand = 0;
+    for (pair<vector<bool>, int> subset: supportCount) {
+      bool isSubset = true;
+      for (int k=0; k<cgraNodeCount and isSubset; ++k)
+        if (subset.first[k] and !group.first[k])
+          isSubset = false;
+      if (isSubset)
+        demand += subset.second;
+    }
+    if (demand > free)
+      return true;
+  }
+
+  // The consumer cannot start earlier than one cycle after the producer
+  // starts, or the last cycle of the multi-cycle producer.
+  map<DFGNode*, int> earliest;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    if (m_mapping.find(dfgNode) != m_mapping.end()) {
+      earliest[dfgNode] = m_mappingTiming[dfgNode];
+      continue;
+    }
+    earliest[dfgNode] = 0;
+    for (DFGNode* pred: *(dfgNode->getPredNodes())) {
+      if (isBackEdge(pred, dfgNode))
+        continue;
+      int delay = pred->getExecLatency() - 1 > 1 ? pred->getExecLatency() - 1 : 1;
+      if (earliest[pred] + delay > earliest[dfgNode])
+        earliest[dfgNode] = earliest[pred] + delay;
+    }
+    if (earliest[dfgNode] >= m_maxMappingCycle)
+      return true;
+  }
+
+  // Each DFGEdge with an unmapped end takes at least one cycle.
+  for (int cycleID=0; cycleID<(int)m_recurrences.size(); ++cycleID) {
+    int totalTime = m_recurrenceTime[cycleID] + m_recurrences[cycleID].size() -
+                    m_recurrenceMappedEdges[cycleID];
+    if (totalTime > t_II)
+      return true;
+  }
+  return false;
+}
+
+vector<int> Mapper::getNogoodSignature(int t_II, DFGNode* t_dfgNode,
+    map<CGRANode*, int>* t_path) {
+  CGRANode* fu = NULL;
+  int cycle = -1;
+  for (map<CGRANode*, int>::iterator iter=t_path->begin();
+      iter!=t_path->end(); ++iter) {
+    if ((*iter).second > cycle) {
+      fu = (*iter).first;
+      cycle = (*iter).second;
+    }
+  }
+  vector<int> signature;
+  signature.push_back(t_dfgNode->getID());
+  signature.push_back(fu->getID());
+  signature.push_back(cycle % t_II);
+  list<DFGNode*> neighbors(*(t_dfgNode->getPredNodes()));
+  neighbors.insert(neighbors.end(), t_dfgNode->getSuccNodes()->begin(),
+                   t_dfgNode->getSuccNodes()->end());
+  for (DFGNode* neighbor: neighbors) {
+    if (m_mapping.find(neighbor) == m_mapping.end())
+      continue;
+    signature.push_back(neighbor->getID());
+    signature.push_back(m_mapping[neighbor]->getID());
+    signature.push_back(m_mappingTiming[neighbor] - cycle);
+  }
+  return signature;
+}
+
+/**
+ * what is in this function:
+ * 1. enumerate the horizontal mirror, the vertical mirror and their combinations, plus the transposes (rotations) for the square mesh.
+ * 2. keep the ones that map every CGRANode to a CGRANode with the same capabilities, and every CGRALink to a CGRALink in the same status.
+ */
+void Mapper::findSymmetries(CGRA* t_cgra, DFG* t_dfg) {
+  int rows = t_cgra->getRows();
+  int columns = t_cgra->getColumns();
+  int candidateCount = rows == columns ? 8 : 4;
+  // The first candidate is the identity.
+  for (int k=1; k<candidateCount; ++k) {
+    vector<int> permutation(rows * columns);
+    for (int y=0; y<rows; ++y) {
+      for (int x=0; x<columns; ++x) {
+        int imageX = (k & 1) ? columns - 1 - x : x;
+        int imageY = (k & 2) ? rows - 1 - y : y;
+        if (k & 4)
+          swap(imageX, imageY);
+        permutation[y * columns + x] = imageY * columns + imageX;
+      }
+    }
+    bool isSymmetry = true;
+    for (int i=0; i<rows*columns and isSymmetry; ++i) {
+      CGRANode* cgraNode = t_cgra->nodes[i / columns][i % columns];
+      CGRANode* image = t_cgra->nodes[permutation[i] / columns][permutation[i] % columns];
+      if (cgraNode->canLoad() != image->canLoad() or
+          cgraNode->canStore() != image->canStore())
+        isSymmetry = false;
+      for (DFGNode* dfgNode: t_dfg->nodes)
+        if (cgraNode->canSupport(dfgNode) != image->canSupport(dfgNode))
+          isSymmetry = false;
+    }
+    vector<int> linkPermutation(t_cgra->getLinkCount());
+    for (int i=0; i<t_cgra->getLinkCount() and isSymmetry; ++i) {
+      CGRALink* link = t_cgra->links[i];
+      int src = permutation[link->getSrc()->getY() * columns + link->getSrc()->getX()];
+      int dst = permutation[link->getDst()->getY() * columns + link->getDst()->getX()];
+      CGRALink* image = t_cgra->getLink(t_cgra->nodes[src / columns][src % columns],
+                                        t_cgra->nodes[dst / columns][dst % columns]);
+      if (image == NULL or image->isDisabled() != link->isDisabled())
+        isSymmetry = false;
+      else
+        linkPermutation[i] = image->getID();
+    }
+    if (isSymmetry) {
+      m_symmetries.push_back(permutation);
+      m_linkSymmetries.push_back(linkPermutation);
+    }
+  }
+  cout<<"[DEBUG] found "<<m_symmetries.size()<<" non-trivial symmetries of CGRA\n";
+}
+
+list<int> Mapper::getActiveSymmetries(CGRA* t_cgra, int t_II) {
+  list<int> activeSymmetries;
+  int columns = t_cgra->getColumns();
+  for (int k=0; k<(int)m_symmetries.size(); ++k) {
+    bool isActive = true;
+    for (map<DFGNode*, CGRANode*>::iterator iter=m_mapping.begin();
+        iter!=m_mapping.end() and isActive; ++iter) {
+      int index = (*iter).second->getY() * columns + (*iter).second->getX();
+      if (m_symmetries[k][index] != index)
+        isActive = false;
+    }
+    for (int i=0; i<t_cgra->getLinkCount() and isActive; ++i) {
+      CGRALink* link = t_cgra->links[i];
+      CGRALink* image = t_cgra->links[m_linkSymmetries[k][i]];
+      for (int cycle=0; cycle<t_II; ++cycle) {
+        if (link->isOccupied(cycle) != image->isOccupied(cycle) or
+            link->getMappedDFGNode(cycle) != image->getMappedDFGNode(cycle)) {
+          isActive = false;
+          break;
+        }
+      }
+    }
+    if (isActive)
+      activeSymmetries.push_back(k);
+  }
+  return activeSymmetries;
+}
+
+/**
+ * what is in this function:
+ * 1. without the dynamic ordering, return the DFGNode after the mapped ones in m_dfsOrder.
+ * 2. count the free FU slots within II of each CGRANode.
+ * 3. for each unmapped DFGNode whose forward predecessors are mapped, sum the free FU slots of the CGRANodes supporting it, and return the one with the smallest sum.
+ */
+DFGNode* Mapper::getNextDFSNode(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    list<DFGNode*>* t_mappedDFGNodes) {
+  if (t_mappedDFGNodes->size() == t_dfg->nodes.size())
+    return NULL;
+  if (!m_dfsDynamicOrdering)
+    return m_dfsOrder[t_mappedDFGNodes->size()];
+
+  vector<vector<int>> freeSlots(t_cgra->getRows(),
+                                vector<int>(t_cgra->getColumns(), 0));
+  for (int i=0; i<t_cgra->getRows(); ++i)
+    for (int j=0; j<t_cgra->getColumns(); ++j)
+      for (int cycle=0; cycle<t_II; ++cycle)
+        if (!t_cgra->nodes[i][j]->isOccupied(cycle, t_II))
+          ++freeSlots[i][j];
+  set<DFGNode*> mapped(t_mappedDFGNodes->begin(), t_mappedDFGNodes->end());
+  map<DFGNode*, int> position;
+  for (DFGNode* dfgNode: t_dfg->nodes)
+    position[dfgNode] = position.size();
+  DFGNode* mostConstrained = NULL;
+  int fewestCandidates = -1;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    if (mapped.find(dfgNode) != mapped.end())
+      continue;
+    bool isReady = true;
+    for (DFGNode* pred: *(dfgNode->getPredNodes()))
+      if (position[pred] < position[dfgNode] and mapped.find(pred) == mapped.end())
+        isReady = false;
+    if (!isReady)
+      continue;
+    int candidates = 0;
+    for (int i=0; i<t_cgra->getRows(); ++i)
+      for (int j=0; j<t_cgra->getColumns(); ++j)
+        if (t_cgra->nodes[i][j]->canSupport(dfgNode))
+          candidates += freeSlots[i][j];
+    if (mostConstrained == NULL or candidates < fewestCandidates) {
+      mostConstrained = dfgNode;
+      fewestCandidates = candidates;
+    }
+  }
+  return mostConstrained;
+}
+
+/**
+ * what is in this function:
+ * 1. sweep the CGRANodes reachable from the CGRANode of t_dfgNode over the CGRALinks that can carry its data, and the CGRANodes reaching it over the CGRALinks with a free slot.
+ * 2. each unmapped successor (predecessor) should be able to occupy one of the reachable (reaching) CGRANodes within II.
+ */
+bool Mapper::forwardCheck(int t_II, DFGNode* t_dfgNode) {
+  CGRANode* fu = m_mapping[t_dfgNode];
+  set<CGRANode*> reachable;
+  set<CGRANode*> reaching;
+  list<CGRANode*> queue;
+  reachable.insert(fu);
+  queue.push_back(fu);
+  while (queue.size() != 0) {
+    CGRANode* cgraNode = queue.front();
+    queue.pop_front();
+    for (CGRALink* link: *(cgraNode->getOutLinks())) {
+      if (reachable.find(link->getDst()) != reachable.end())
+        continue;
+      for (int cycle=0; cycle<t_II; ++cycle) {
+        if (link->canOccupy(t_dfgNode, fu, cycle, t_II)) {
+          reachable.insert(link->getDst());
+          queue.push_back(link->getDst());
+          break;
+        }
+      }
+    }
+  }
+  reaching.insert(fu);
+  queue.push_back(fu);
+  while (queue.size() != 0) {
+    CGRANode* cgraNode = queue.front();
+    queue.pop_front();
+    for (CGRALink* link: *(cgraNode->getInLinks())) {
+      if (reaching.find(link->getSrc()) != reaching.end())
+        continue;
+      for (int cycle=0; cycle<t_II; ++cycle) {
+        if (link->canOccupy(cycle, t_II)) {
+          reaching.insert(link->getSrc());
+          queue.push_back(link->getSrc());
+          break;
+        }
+      }
+    }
+  }
+
+  for (int k=0; k<2; ++k) {
+    list<DFGNode*>* neighbors = k == 0 ? t_dfgNode->getSuccNodes() :
+                                         t_dfgNode->getPredNodes();
+    set<CGRANode*>* candidates = k == 0 ? &reachable : &reaching;
+    for (DFGNode* neighbor: *neighbors) {
+      if (m_mapping.find(neighbor) != m_mapping.end())
+        continue;
+      bool isFeasible = false;
+      for (CGRANode* cgraNode: *candidates) {
+        for (int cycle=0; cycle<t_II and !isFeasible; ++cycle)
+          if (cgraNode->canOccupy(neighbor, cycle, t_II))
+            isFeasible = true;
+        if (isFeasible)
+          break;
+      }
+      if (!isFeasible) {
+        cout<<"[DEBUG] no feasible CGRA node is left for DFG node "<<neighbor->getID()<<" after scheduling DFG node "<<t_dfgNode->getID()<<"\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * what is in this function:
+ * 1. construct the MRRG again, which clears m_mapping, m_mappingTiming and the occupancy of CGRANodes and CGRALinks.
+ * 2. schedule the recorded paths one by one in the original order, so the state before the failed schedule() is rebuilt.
+ */
+bool Mapper::replaySchedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    list<DFGNode*>* t_scheduledDFGNodes,
+    list<map<CGRANode*, int>*>* t_scheduledPaths,
+    bool t_isStaticElasticCGRA) {
+  constructMRRG(t_dfg, t_cgra, t_II);
+  list<DFGNode*>::iterator dfgNodeItr = t_scheduledDFGNodes->begin();
+  for (map<CGRANode*, int>* path: *t_scheduledPaths) {
+    if (!schedule(t_cgra, t_dfg, t_II, *dfgNodeItr, path,
+        t_isStaticElasticCGRA)) {
+      return false;
+    }
+    ++dfgNodeItr;
+  }
+  return true;
+}
+
 // This helper function assume the cycle for each mapped CGRANode increases
 // gradually along the path. Otherwise, the map struct will get conflict key.
 map<int, CGRANode*>* Mapper::getReorderPath(map<CGRANode*, int>* t_path) {
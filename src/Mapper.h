@@ -10,6 +10,38 @@
 
 #include "DFG.h"
 #include "CGRA.h"
+#include <atomic>
+#include <random>
+#include <chrono>
+
+/** The cost policies of getPathCost(), getTileCost() and getCostLowerBound(), the mapper is instantiated with one of them per call site, so the terms that a policy turns off are removed at compile time.
+ * distanceWeight : the weight of the cycle the path reaches the target CGRANode
+ * congestionAware : whether the pressure on the CGRALinks (m_linkPressure) is counted
+ * registerAware : whether the registers a path waits in are counted
+ */
+struct HeuristicCostPolicy {
+  static constexpr float distanceWeight = 1;
+  static constexpr bool congestionAware = false;
+  static constexpr bool registerAware = false;
+};
+
+struct CongestionCostPolicy {
+  static constexpr float distanceWeight = 1;
+  static constexpr bool congestionAware = true;
+  static constexpr bool registerAware = false;
+};
+
+struct LatencyCostPolicy {
+  static constexpr float distanceWeight = 4;
+  static constexpr bool congestionAware = false;
+  static constexpr bool registerAware = false;
+};
+
+struct RegisterCostPolicy {
+  static constexpr float distanceWeight = 1;
+  static constexpr bool congestionAware = false;
+  static constexpr bool registerAware = true;
+};
 
 class Mapper {
   private:
@@ -22,6 +54,139 @@ class Mapper {
 		 */
     map<DFGNode*, int> m_mappingTiming;
 
+		/** The earliest cycle each DFGNode can start at under the current II, derived from the latencies along the forward edges and the recurrences.
+		 */
+    map<DFGNode*, int> m_asap;
+
+		/** The latest cycle each DFGNode can start at under the current II, so that all of its successors still start within the schedule length (the critical path with each cycle stretched by one II, see computeSchedulingWindows()).
+		 */
+    map<DFGNode*, int> m_alap;
+
+		/** The II m_asap and m_alap are computed for, -1 means not computed yet.
+		 */
+    int m_windowII;
+
+		/** This function computes the ASAP/ALAP scheduling window of each DFGNode for the II, calculateCost() and dijkstra_search() only search the cycles inside the window.
+		 * the back edges (dst precedes src in t_dfg->nodes) carry a distance of one iteration, i.e., dst may start II cycles earlier than src finishes.
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 */
+    void computeSchedulingWindows(DFG* t_dfg, int t_II);
+
+		/** The position of each DFGNode on each recurrence cycle, indexed by the cycle IDs of the DFGNodes (the order of t_dfg->getCycleLists()).
+		 */
+    vector<map<DFGNode*, int>> m_recurrencePositions;
+
+		/** The DFGNodes of each recurrence cycle in the order of the cycle.
+		 */
+    vector<vector<DFGNode*>> m_recurrences;
+
+		/** The total time of the DFGEdges with both ends mapped on each recurrence cycle, and the number of such DFGEdges. They are kept up to date by setMappingTiming() under m_recurrenceII.
+		 */
+    vector<int> m_recurrenceTime;
+    vector<int> m_recurrenceMappedEdges;
+    int m_recurrenceII;
+
+		/** The position of each DFGNode in t_dfg->nodes, a DFGEdge is a back edge if its dst does not come after its src.
+		 */
+    map<DFGNode*, int> m_dfgNodePositions;
+
+		/** This function tells whether the DFGEdge from t_src to t_dst is a back edge (it carries the data to the next iteration).
+		 */
+    bool isBackEdge(DFGNode* t_src, DFGNode* t_dst);
+
+		/** This function tells whether the mapped t_pred is ignored when t_dfgNode is placed: in the swing order, the data through a back edge comes from the previous iteration and does not bound the cycle of t_dfgNode from below, so calculateCost(), getCostLowerBound() and scheduleWithRollback() skip it and schedule() routes it to the next iteration. The level order keeps all the predecessors.
+		 * @param t_pred : the predecessor of t_dfgNode
+		 * @param t_dfgNode : the DFGNode to place
+		 * @return : true if the DFGEdge from t_pred is skipped
+		 */
+    bool isSkippedBackEdge(DFGNode* t_pred, DFGNode* t_dfgNode);
+
+		/** This function builds the recurrence cycles and m_dfgNodePositions of t_dfg, only once for each DFG, so that isBackEdge() also works before constructMRRG().
+		 * @param t_dfg : the pointer to the DFG
+		 */
+    void buildRecurrences(DFG* t_dfg);
+
+		/** This function calls buildRecurrences() and clears the times of the recurrence cycles for the II.
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 */
+    void initRecurrenceTiming(DFG* t_dfg, int t_II);
+
+		/** The DFG m_recurrences and m_dfgNodePositions are built for, they are only built again for another DFG.
+		 */
+    DFG* m_recurrenceDFG;
+
+		/** This function recomputes the times of the recurrence cycles from m_mappingTiming, it is called after m_mappingTiming is replaced as a whole.
+		 */
+    void resetRecurrenceTiming();
+
+		/** This function returns the time of the DFGEdge from the t_index-th DFGNode to the next one on the t_cycleID-th recurrence cycle, counted as in tryToRoute().
+		 * @return : the time, or -1 if either end is not mapped
+		 */
+    int getRecurrenceEdgeTime(int t_cycleID, int t_index);
+
+		/** This function maps t_dfgNode at t_cycle in m_mappingTiming and updates the times of the recurrence cycles it is on.
+		 * @param t_dfgNode : the DFGNode
+		 * @param t_cycle : the cycle t_dfgNode is mapped at
+		 */
+    void setMappingTiming(DFGNode* t_dfgNode, int t_cycle);
+
+		/** True means dijkstra_search() and tryToRoute() expand the CGRANodes in the order of the cycles so far plus the hop distance to the dst CGRANode (A*), it comes from the "aStarRouting" param in param.json.
+		 */
+    bool m_aStarRouting;
+
+		/** True means tryToRoute() lets the data leave from any CGRANode it already passes (recorded with CGRANode::addMulticastArrival()), and schedule() routes the successors nearest first, so the routes of one DFGNode form a multicast tree, it comes from the "multicastRouting" param in param.json.
+		 */
+    bool m_multicastRouting;
+
+		/** True means getMappingOrder() moves each recurrence cycle, together with the DFGNodes it depends on, before the rest of the DFG (the longest cycle first), and calculateCost() only returns the slots that can keep the total time around the recurrence cycles within II, it comes from the "recurrenceFirst" param in param.json.
+		 */
+    bool m_recurrenceFirst;
+
+		/** This function moves the recurrence cycles of t_dfg to the front of t_order.
+		 * each cycle is moved with all the DFGNodes it depends on through the forward DFGEdges, keeping their relative order in t_order, so the predecessors are still mapped before the successors.
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_order : the mapping order to reorder
+		 */
+    void placeRecurrencesFirst(DFG* t_dfg, list<DFGNode*>* t_order);
+
+		/** The order to map the DFGNodes, one of the *_MAPPING_ORDER values in Mapper.cpp, it comes from the "mappingOrder" param in param.json.
+		 */
+    int m_mappingOrder;
+
+		/** In the swing order, a DFGNode mapped before all its neighbors starts at m_swingSeedStretch times its ASAP cycle instead of the ASAP cycle: its predecessors are mapped later bottom-up, and besides the ASAP cycles to execute they need the cycles to route between the tiles. It comes from the "swingSeedStretch" param in param.json.
+		 */
+    int m_swingSeedStretch;
+
+		/** This function gets the mapping order of Swing Modulo Scheduling.
+		 * 1. the recurrence cycles (longest first), each with the DFGNodes on the paths between it and the former ones, then the rest of the DFG are ordered set by set.
+		 * 2. within a set, the order sweeps top-down (the largest height first) and bottom-up (the largest depth first) in turn, starting from the DFGNodes next to the ordered ones, so that each DFGNode has ordered neighbors on one side only. The smaller mobility wins the tie, then the position in DFG (or a random one if m_randomSeed is not -1).
+		 * only the forward DFGEdges are considered, and a DFGNode whose successors are mapped first is placed as late as they allow in calculateCost().
+		 * @param t_dfg : the pointer to the DFG
+		 * @return : the list of DFGNodes in mapping order
+		 */
+    list<DFGNode*>* getSwingOrder(DFG* t_dfg);
+
+		/** This function gets the order in which iterativeModuloMap, DFSMap and placeUnmapped pick the DFGNodes, it is t_dfg->nodes, or getSwingOrder() with the "swing" mapping order.
+		 * @param t_dfg : the pointer to the DFG
+		 * @return : the list of DFGNodes in priority order
+		 */
+    list<DFGNode*>* getPriorityOrder(DFG* t_dfg);
+
+		/** The priority order of DFSMap in the current exhaustiveMap.
+		 */
+    vector<DFGNode*> m_dfsOrder;
+
+		/** This function checks whether mapping t_dfgNode at t_cycle can still keep the total time around each recurrence cycle it is on within II.
+		 * only the cycles of t_dfgNode->getCycleIDs() are checked, the DFGEdges into and out of t_dfgNode are timed again as in getRecurrenceEdgeTime(), the other mapped ones keep their time in m_recurrenceTime, and the DFGEdges with an unmapped end take at least one cycle each.
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the DFGNode to map
+		 * @param t_cycle : the cycle to map t_dfgNode at
+		 * @return : true if no recurrence cycle is violated
+		 */
+    bool fitsRecurrences(int t_II, DFGNode* t_dfgNode, int t_cycle);
+
     map<CGRANode*, int>* dijkstra_search(CGRA*, DFG*, int, DFGNode*,
                                          DFGNode*, CGRANode*);
     int getMaxMappingCycle();
@@ -30,7 +195,6 @@ class Mapper {
 		 * try to route the date from srcCGRAnode which has mapped srcDFGNode to the dstCGRANode which mapped dstDFGNode.
 		 * in this function we first find a shortest path from srcCGRANode to dstCGRANode,then occupy the CGRALinks in this Path.
 		 * @param t_caga : the pointer to the CGRA 
-		 * @param t_dfg : the pointer to the DFG
 		 * @param t_II : the value of II
 		 * @param t_srcDFGNode : the pointer of srcDFGNode
 		 * @param t_srcCGRANode : the pointer of srcCGRANode
@@ -41,12 +205,213 @@ class Mapper {
 		 * @param t_isStaticElasticCGRA : is always false now
 		 * @return : the reordered paths
 		 */
-		bool tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, DFGNode* t_dstDFGNode,CGRANode* t_dstCGRANode, int t_dstCycle, bool t_isBackedge,bool t_isStaticElasticCGRA);
+		bool tryToRoute(CGRA* t_cgra, int t_II, DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, DFGNode* t_dstDFGNode,CGRANode* t_dstCGRANode, int t_dstCycle, bool t_isBackedge,bool t_isStaticElasticCGRA);
+
+		/** This function checks whether a route of the data of t_srcDFGNode can start from t_cgraNode of its multicast tree, in dijkstra_search() and tryToRoute() alike.
+		 * the tree only records the CGRANodes the data bypasses, t_dstCGRANode is left out (the data needs to arrive there through a link to be kept in a register), and so is the CGRANode whose tree path back to t_srcCGRANode passes t_dstCGRANode.
+		 * @param t_caga : the pointer to the CGRA
+		 * @param t_srcDFGNode : the DFGNode of the data
+		 * @param t_srcCGRANode : the CGRANode t_srcDFGNode is mapped onto
+		 * @param t_cgraNode : the CGRANode to branch from
+		 * @param t_dstCGRANode : the CGRANode the route goes to
+		 * @param t_srcTiming : the cycle the data leaves t_srcCGRANode
+		 * @return : true if the route can branch from t_cgraNode
+		 */
+		bool canBranchFrom(CGRA* t_cgra, DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, CGRANode* t_cgraNode, CGRANode* t_dstCGRANode, int t_srcTiming);
 
     list<DFGNode*>* getMappedDFGNodes(DFG*, CGRANode*);
     map<int, CGRANode*>* getReorderPath(map<CGRANode*, int>*);
     bool DFSMap(CGRA*, DFG*, int, list<DFGNode*>*, list<map<CGRANode*, int>*>*, bool);
 
+		/** The number of lower-ranked candidate paths heuristicMap tries after the top-ranked one fails in schedule(), before giving up the current II.
+		 */
+    int m_rollbackCandidates;
+
+		/** This function undo the partial schedule by constructing the MRRG again and re-scheduling the recorded paths in order.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_scheduledDFGNodes : the DFGNodes that have been scheduled successfully, in schedule order
+		 * @param t_scheduledPaths : the paths used to schedule t_scheduledDFGNodes
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : true if every recorded path can be scheduled again
+		 */
+		bool replaySchedule(CGRA* t_cgra, DFG* t_dfg, int t_II, list<DFGNode*>* t_scheduledDFGNodes, list<map<CGRANode*, int>*>* t_scheduledPaths, bool t_isStaticElasticCGRA);
+
+		/** This function collect the paths of t_dfgNode on every CGRANode, then try to schedule the candidates in the order of cost. When schedule() (or forwardCheck()) fails, the changes it made to the CGRANodes and CGRALinks are undone (see recordForRollback()) and the next candidate is tried, up to m_rollbackCandidates extra candidates.
+		 * the successful schedule is appended to t_scheduledDFGNodes and t_scheduledPaths.
+		 * if all candidates fail, the MRRG is left as it was before this function.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_scheduledDFGNodes : the DFGNodes that have been scheduled successfully, in schedule order
+		 * @param t_scheduledPaths : the paths used to schedule t_scheduledDFGNodes
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : true if t_dfgNode is scheduled
+		 */
+		bool scheduleWithRollback(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<DFGNode*>* t_scheduledDFGNodes, list<map<CGRANode*, int>*>* t_scheduledPaths, bool t_isStaticElasticCGRA);
+
+		/** True means scheduleWithRollback() is trying a candidate, and schedule() records its changes to the MRRG.
+		 */
+    bool m_isRollbackRecording;
+
+		/** The CGRANodes and CGRALinks that record their changes since the candidate is tried.
+		 */
+    set<CGRANode*> m_rollbackCGRANodes;
+    set<CGRALink*> m_rollbackCGRALinks;
+
+		/** These functions let t_cgraNode (or t_cgraLink and its dst CGRANode, whose registers it allocates) record the changes schedule() is about to make, so that a failed candidate can be undone with endRollbackRecording(). They do nothing unless m_isRollbackRecording.
+		 * @param t_cgraNode : the CGRANode to be changed
+		 * @param t_cgraLink : the CGRALink to be changed
+		 */
+    void recordForRollback(CGRANode* t_cgraNode);
+    void recordForRollback(CGRALink* t_cgraLink);
+
+		/** This function stops the recording of the CGRANodes and CGRALinks in recordForRollback().
+		 * @param t_isUndone : true means their changes are undone, otherwise kept
+		 */
+    void endRollbackRecording(bool t_isUndone);
+
+		/** True means heuristicMap() seeds the attempt at II+1 with the CGRANodes the DFGNodes were scheduled onto in the failed attempt at II, and repairs the conflicts of the seeded attempt with scheduleByEviction() (at most once per DFGNode on average) instead of giving up the II, it comes from the "warmStart" param in param.json.
+		 */
+    bool m_warmStart;
+
+		/** The CGRANodes the DFGNodes were scheduled onto in the last failed attempt of heuristicMap(), empty if m_warmStart is false.
+		 */
+    map<DFGNode*, CGRANode*> m_warmStartMapping;
+
+		/** This function tries to schedule t_dfgNode onto the CGRANode it had in the last failed attempt (m_warmStartMapping), the cycle is found again by calculateCost() on the MRRG of the current II.
+		 * if it fails, the partial schedule is undone with replaySchedule(), so that scheduleWithRollback() can repair it on the other CGRANodes.
+		 * @param t_caga : the pointer to the CGRA
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_scheduledDFGNodes : the DFGNodes that have been scheduled successfully, in schedule order
+		 * @param t_scheduledPaths : the paths used to schedule t_scheduledDFGNodes
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : true if t_dfgNode is scheduled onto its former CGRANode
+		 */
+		bool scheduleWarmStart(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<DFGNode*>* t_scheduledDFGNodes, list<map<CGRANode*, int>*>* t_scheduledPaths, bool t_isStaticElasticCGRA);
+
+		/** The budget of iterativeModuloMap for each II is m_imsBudgetRatio * the number of DFGNodes scheduling attempts.
+		 */
+    int m_imsBudgetRatio;
+
+		/** This function rebuild the MRRG from the recorded schedules after some of them are evicted.
+		 * a recorded path can only be reused if its target CGRANode is still free and the DFGNode at the beginning of the path is still mapped there, otherwise the record is dropped.
+		 * a record that fails in schedule() is dropped too, and the MRRG is rebuilt again without it.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_scheduledDFGNodes : the DFGNodes that are still scheduled, in schedule order
+		 * @param t_scheduledPaths : the paths used to schedule t_scheduledDFGNodes
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : the number of the dropped records
+		 */
+		int repairSchedule(CGRA* t_cgra, DFG* t_dfg, int t_II, list<DFGNode*>* t_scheduledDFGNodes, list<map<CGRANode*, int>*>* t_scheduledPaths, bool t_isStaticElasticCGRA);
+
+		/** This function choose the DFGNodes to be evicted so that t_dfgNode can be placed.
+		 * the FU is forced on the CGRANode that supports t_dfgNode with the fewest DFGNodes occupying its modulo slot, the slot is the earliest the data of the mapped predecessors can arrive, and not earlier than the last forced one of t_dfgNode.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode that cannot be placed
+		 * @param t_evictNeighbors : true means the mapped predecessors and successors of t_dfgNode are evicted as well
+		 * @param t_lastForcedCycle : the last forced cycle of each DFGNode, updated in this function
+		 * @param t_victims : the DFGNodes to be evicted
+		 * @param t_forcedCycle : the forced cycle, set in this function
+		 * @return : the forced CGRANode, NULL if no CGRANode supports t_dfgNode
+		 */
+		CGRANode* getEvictionVictims(CGRA* t_cgra, int t_II, DFGNode* t_dfgNode, bool t_evictNeighbors, map<DFGNode*, int>* t_lastForcedCycle, set<DFGNode*>* t_victims, int* t_forcedCycle);
+
+		/** This function schedules t_dfgNode onto t_fu at t_cycle, and undoes the partial schedule with replaySchedule() if it fails.
+		 * @param t_caga : the pointer to the CGRA
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_fu : the CGRANode to map t_dfgNode onto
+		 * @param t_cycle : the cycle to map t_dfgNode at
+		 * @param t_scheduledDFGNodes : the DFGNodes that have been scheduled successfully, in schedule order
+		 * @param t_scheduledPaths : the paths used to schedule t_scheduledDFGNodes
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : true if t_dfgNode is scheduled onto the slot
+		 */
+		bool scheduleOnSlot(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, CGRANode* t_fu, int t_cycle, list<DFGNode*>* t_scheduledDFGNodes, list<map<CGRANode*, int>*>* t_scheduledPaths, bool t_isStaticElasticCGRA);
+
+		/** This function evicts the DFGNodes in the way of t_dfgNode after it fails in scheduleWithRollback(), and schedules it onto the forced FU slot of getEvictionVictims(), first evicting the DFGNodes on that slot, then its mapped neighbors as well.
+		 * the evicted DFGNodes, and the ones dropped by repairSchedule(), become unscheduled.
+		 * @param t_caga : the pointer to the CGRA
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode that cannot be placed
+		 * @param t_scheduledDFGNodes : the DFGNodes that have been scheduled successfully, in schedule order
+		 * @param t_scheduledPaths : the paths used to schedule t_scheduledDFGNodes
+		 * @param t_lastForcedCycle : the last forced cycle of each DFGNode, updated in this function
+		 * @param t_evictions : the number of the evicted and dropped DFGNodes, increased in this function
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : true if t_dfgNode is scheduled
+		 */
+		bool scheduleByEviction(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<DFGNode*>* t_scheduledDFGNodes, list<map<CGRANode*, int>*>* t_scheduledPaths, map<DFGNode*, int>* t_lastForcedCycle, int* t_evictions, bool t_isStaticElasticCGRA);
+
+		/** The maximum number of rip-up-and-reroute iterations of negotiatedRoute, 0 means the negotiated routing is disabled.
+		 */
+    int m_pathFinderIterations;
+
+		/** This function places the DFGNodes that are not mapped yet without routing them, the routing is left to negotiatedRoute().
+		 * each DFGNode is placed onto the CGRANode and the earliest idle cycle that minimize the distance to its placed neighbors.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_isTimingStrict : true means a DFGNode is not placed where its placed successors cannot be reached in time
+		 * @return : false if any DFGNode cannot be placed
+		 */
+		bool placeUnmapped(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isTimingStrict);
+
+		/** This function routes all the DFGEdges for the fixed placement in m_mapping and m_mappingTiming with negotiated congestion (PathFinder).
+		 * each iteration rips up and reroutes every DFGEdge, a CGRALink slot can be temporarily overused by different DFGNodes, and the cost of the overused slots grows with the present and history congestion until the routing is legal.
+		 * the legal routing is committed onto the MRRG, which is constructed again.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @return : true if a legal routing is committed, false if it does not converge or some DFGEdge cannot be routed at all
+		 */
+		bool negotiatedRoute(CGRA* t_cgra, DFG* t_dfg, int t_II);
+
+		/** This function searches the cheapest route of one DFGEdge in the time-extended CGRA under the current congestion costs.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_II : the value of II
+		 * @param t_srcDFGNode : the DFGNode producing the data
+		 * @param t_srcCGRANode : the CGRANode t_srcDFGNode is mapped onto
+		 * @param t_dstCGRANode : the CGRANode consuming the data
+		 * @param t_departure : the earliest cycle the data can leave t_srcCGRANode
+		 * @param t_deadline : the latest cycle the data should arrive t_dstCGRANode
+		 * @param t_presentFactor : the weight of the present congestion
+		 * @param t_slotUsers : the number of routes of each source DFGNode on each CGRALink slot (link ID * t_II + cycle % t_II)
+		 * @param t_history : the history congestion cost of each CGRALink slot
+		 * @param t_route : the CGRALinks and their cycles along the route, in time order
+		 * @return : false if there is no route within the time window
+		 */
+		bool searchCongestedRoute(CGRA* t_cgra, int t_II, DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, CGRANode* t_dstCGRANode, int t_departure, int t_deadline, float t_presentFactor, vector<map<DFGNode*, int>>* t_slotUsers, vector<float>* t_history, list<pair<CGRALink*, int>>* t_route);
+
+		/** The options of annealingMap, they come from the "annealingIterations", "annealingTemperature", "annealingCooling" and "annealingSeed" params in param.json.
+		 */
+    int m_annealingIterations;
+    float m_annealingTemperature;
+    float m_annealingCooling;
+    int m_annealingSeed;
+
+		/** This function calculates the placement cost of a DFGEdge, according to m_mapping and m_mappingTiming.
+		 * the cost is the distance between the CGRANodes plus the penalty of the timing violation, the data should be delivered to the destination CGRANode before the destination DFGNode starts (one iteration later for the backward DFGEdge).
+		 * @param t_caga : the pointer to the CGRA, the distance is its hop distance, i.e., over the enabled links
+		 * @param t_srcDFGNode : the source DFGNode of the DFGEdge
+		 * @param t_dstDFGNode : the destination DFGNode of the DFGEdge
+		 * @param t_II : the value of II
+		 * @param t_isBackward : true if t_dstDFGNode is before t_srcDFGNode in DFG
+		 * @param t_violation : return the cycles of the timing violation
+		 * @return : the placement cost
+		 */
+		float getPlacementCost(CGRA* t_cgra, DFGNode* t_srcDFGNode, DFGNode* t_dstDFGNode, int t_II, bool t_isBackward, int* t_violation);
+
 		/** This function reorder the paths according the cost
 		 * TODO:just return the path with lowest cost may be a better choice
 		 * @param t_caga : the pointer to the CGRA 
@@ -59,11 +424,493 @@ class Mapper {
 		list<map<CGRANode*, int>*>* getOrderedPotentialPaths(CGRA* t_cgra,
     		DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths);
 
+		/** This function calculates the cost of scheduling t_dfgNode along t_path under the current MRRG, the lower the better.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_path : the path from the fu which process previous DFGNode to the fu process t_dfgNode.
+		 * @return : the cost of the path
+		 */
+		float getPathCost(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, map<CGRANode*, int>* t_path);
+
+		/** The same as getPathCost(), but with the terms of the CostPolicy, getPathCost() only picks the instantiation of m_costPolicy.
+		 */
+		template <class CostPolicy>
+		float getPathCost(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, map<CGRANode*, int>* t_path);
+
+		/** This function calculates the cost of each path in t_paths with the CostPolicy, the paths reaching beyond m_maxMappingCycle are skipped.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_paths : the candidate paths
+		 * @param t_pathsWithCost : the map to record the cost of each path
+		 */
+		template <class CostPolicy>
+		void getPathCosts(CGRA* t_cgra, DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths, map<map<CGRANode*, int>*, float>* t_pathsWithCost);
+
+		/** The cost policy used to rank the candidates, one of the *_COST_POLICY values in Mapper.cpp, it comes from the "costPolicy" param in param.json.
+		 */
+    int m_costPolicy;
+
+		/** The weights of the terms in getPathCost(), getTileCost() and the negotiated routing, they come from the "costWeights" param in param.json.
+		 * m_waitingCost : the penalty of a path that waits on a CGRANode
+		 * m_singleTileCost : the penalty of a path that stays on one CGRANode
+		 * m_fanoutPortCost : the baseline of the penalty of placing a DFGNode with multiple successors, minus the out links of the CGRANode
+		 * m_sharedTileBonus : the bonus of sharing the CGRANode with a predecessor that has more than two successors
+		 * m_busyNeighborCost : the penalty per neighbor DFGNode with more than two successors
+		 * m_memoryTileCost : the penalty of occupying a load/store CGRANode without a load/store
+		 * m_multicastBonus : the bonus per reused CGRALink along the path
+		 * m_freeLinkBonus : the bonus per available CGRALink of the target CGRANode
+		 * m_presentFactor : the initial weight of the present congestion in negotiatedRoute()
+		 * m_presentGrowth : the factor the present congestion weight grows by in each iteration of negotiatedRoute()
+		 * m_registerHoldCost : the cost of staying in the register of a CGRANode for one cycle in searchCongestedRoute()
+		 * m_sharedLinkCost : the cost of a CGRALink slot already used by the same source DFGNode in searchCongestedRoute()
+		 * placeUnmapped() also uses m_memoryTileCost.
+		 */
+    double m_waitingCost;
+    double m_singleTileCost;
+    double m_fanoutPortCost;
+    double m_sharedTileBonus;
+    double m_busyNeighborCost;
+    double m_memoryTileCost;
+    double m_multicastBonus;
+    double m_freeLinkBonus;
+    double m_presentFactor;
+    double m_presentGrowth;
+    double m_registerHoldCost;
+    double m_sharedLinkCost;
+
+		/** This function calculates the part of getPathCost() that only depends on the target CGRANode, e.g., the control memory, the ports and the load/store tiles.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_fu : the target CGRANode
+		 * @return : the cost of the target CGRANode
+		 */
+		template <class CostPolicy>
+		float getTileCost(CGRA* t_cgra, DFG* t_dfg, DFGNode* t_dfgNode, CGRANode* t_fu);
+
+		/** The pressure on each CGRALink (by ID) summed over the modulo slots, i.e., 1 for each occupied slot, plus the routes still to come from the mapped DFGNodes (one for each unmapped successor) spread over the out links of their CGRANodes. It is updated as the links are occupied and the DFGNodes are mapped, and rebuilt with the MRRG.
+		 */
+    vector<float> m_linkPressure;
+
+		/** The II m_linkPressure is kept for.
+		 */
+    int m_linkPressureII;
+
+		/** The weight of the congestion terms in getPathCost() under CongestionCostPolicy, 0 means the congestion is ignored, it comes from the "congestionWeight" param in param.json.
+		 */
+    float m_congestionWeight;
+
+		/** This function tells whether m_linkPressure is kept, i.e., under CongestionCostPolicy with a congestion weight.
+		 */
+    bool isCongestionAware();
+
+		/** This function clears m_linkPressure for the new MRRG.
+		 * @param t_caga : the pointer to the CGRA
+		 * @param t_II : the value of II
+		 */
+    void resetLinkPressure(CGRA* t_cgra, int t_II);
+
+		/** This function adds the pressure of the modulo slot of t_cycle on t_link, it is called before the link is occupied, and only counts the slot if it is free.
+		 * @param t_link : the CGRALink to occupy
+		 * @param t_cycle : the cycle to occupy t_link at
+		 */
+    void addLinkPressure(CGRALink* t_link, int t_cycle);
+
+		/** This function spreads t_routes routes to come over the enabled out links of t_cgraNode in m_linkPressure, a negative t_routes takes them back.
+		 * @param t_cgraNode : the CGRANode the routes start from
+		 * @param t_routes : the number of the routes
+		 */
+    void spreadRouteDemand(CGRANode* t_cgraNode, float t_routes);
+
+		/** This function maps t_dfgNode onto t_fu (m_mapping), and moves the routes to come in m_linkPressure accordingly.
+		 * @param t_dfgNode : the DFGNode to map
+		 * @param t_fu : the CGRANode to map t_dfgNode onto
+		 */
+    void setMapping(DFGNode* t_dfgNode, CGRANode* t_fu);
+
+		/** This function calculates the average pressure of a CGRALink over the modulo slots.
+		 * @param t_link : the CGRALink
+		 * @return : the pressure, 0 if m_linkPressure is not kept
+		 */
+    float getLinkPressure(CGRALink* t_link);
+
+		/** This function estimates a lower bound of getPathCost() for mapping t_dfgNode onto t_fu without routing, based on the hop distances from the mapped predecessors.
+		 * it is only a lower bound if isCostLowerBoundAdmissible().
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_fu : the target CGRANode
+		 * @return : the lower bound of the cost
+		 */
+		float getCostLowerBound(CGRA* t_cgra, DFG* t_dfg, DFGNode* t_dfgNode, CGRANode* t_fu);
+
+		/** The same as getCostLowerBound(), but for the getPathCost() of the CostPolicy.
+		 */
+		template <class CostPolicy>
+		float getCostLowerBound(CGRA* t_cgra, DFG* t_dfg, DFGNode* t_dfgNode, CGRANode* t_fu);
+
+		/** This function tells whether getCostLowerBound() never exceeds getPathCost(), i.e., the multicast bonus of each cycle a path waits is not larger than the distanceWeight of the CostPolicy, otherwise a later arrival can cost less. scheduleWithRollback() only evaluates the candidates lazily if it is.
+		 */
+		bool isCostLowerBoundAdmissible();
+
+		/** True means scheduleWithRollback() routes the CGRANodes in the order of getCostLowerBound(), and stops once the remaining ones cannot beat the candidates it tries, it comes from the "lazyCandidateEvaluation" param in param.json.
+		 */
+    bool m_lazyCandidateEvaluation;
+
+
+		/** The shared token to cancel the mapping, it is set once one of the strategies in portfolioMap succeeds. NULL means the mapping cannot be cancelled.
+		 */
+    atomic<bool>* m_cancelToken;
+
+		/** The Mapper that runs this copy with its own m_cancelToken (portfolioMap, exhaustiveMap and parallelDFSMap), this copy is also cancelled once that one is. NULL means there is no such Mapper.
+		 */
+    Mapper* m_cancelParent;
+
+		/** The largest II the mapping functions try, -1 means no limit.
+		 */
+    int m_maxII;
+
+		/** The seed of the randomized mapping order and tie-breaks, -1 means the order of DFG and the deterministic tie-breaks are used.
+		 */
+    int m_randomSeed;
+    mt19937 m_random;
+
+		/** The number of paths DFSMap can try to schedule for each II in exhaustiveMap, 0 means no limit.
+		 */
+    int m_dfsExpansionBudget;
+    int m_dfsExpansions;
+
+		/** The seconds DFSMap can search for each II in exhaustiveMap, 0 means no limit. It comes from the "dfsTimeBudget" param in param.json.
+		 */
+    int m_dfsTimeBudget;
+    chrono::steady_clock::time_point m_dfsDeadline;
+
+		/** The number of the partial mappings DFSMap pruned with violatesLowerBounds() in one exhaustiveMap.
+		 */
+    int m_dfsPrunings;
+
+		/** This function checks the lower bounds of the current partial mapping, the partial mapping cannot be completed if any of them is violated.
+		 * 1. for the unmapped DFGNodes supported by the same set of CGRANodes, the number of them and the DFGNodes supported by its subsets should not exceed the free FU slots of the set within II.
+		 * 2. the earliest cycle of each unmapped DFGNode, propagated from its mapped predecessors along the forward DFGEdges, should be within the maximum mapping cycle.
+		 * 3. the total time around each recurrence cycle (m_recurrenceTime), counting at least one cycle for each DFGEdge with an unmapped end, should not exceed II (the same check as tryToRoute()).
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @return : true if the partial mapping can be pruned
+		 */
+    bool violatesLowerBounds(CGRA* t_cgra, DFG* t_dfg, int t_II);
+
+		/** The nogoods DFSMap learns from the failed schedule() in one exhaustiveMap, each one is the signature from getNogoodSignature(). m_dfsNogoodLearning comes from the "dfsNogoodLearning" param in param.json, false by default.
+		 * the signature does not cover the link, bypass and ctrl-mem occupancy of the other DFGNodes, so a nogood can prune a candidate that would succeed under another partial mapping, and the search is no longer complete with it.
+		 */
+    bool m_dfsNogoodLearning;
+    set<vector<int>> m_dfsNogoods;
+    int m_dfsNogoodHits;
+
+		/** This function gets the signature of scheduling t_dfgNode along t_path, which is the (DFGNode, CGRANode, slot) sub-assignment that the routing of the schedule depends on.
+		 * the signature contains the ID of t_dfgNode, its CGRANode and its cycle % II, and the ID, CGRANode and the relative cycle of each mapped predecessor and successor of t_dfgNode.
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the dfgNode need to be mapped
+		 * @param t_path : the path from the fu which process previous DFGNode to the fu process t_dfgNode.
+		 * @return : the signature
+		 */
+    vector<int> getNogoodSignature(int t_II, DFGNode* t_dfgNode, map<CGRANode*, int>* t_path);
+
+		/** The non-trivial symmetries of the CGRA found in exhaustiveMap, each one is the permutation of the CGRANodes (index: y * columns + x) and the permutation of the CGRALinks (index: link ID). m_dfsSymmetryBreaking comes from the "dfsSymmetryBreaking" param in param.json.
+		 */
+    bool m_dfsSymmetryBreaking;
+    vector<vector<int>> m_symmetries;
+    vector<vector<int>> m_linkSymmetries;
+    int m_dfsSymmetryPrunings;
+
+		/** This function finds the mirrors and rotations of the mesh that keep the topology and the capabilities of the CGRA, they are saved in m_symmetries and m_linkSymmetries.
+		 * a mirror or rotation is a symmetry if every CGRANode is mapped to a CGRANode supporting the same DFGNodes, and every CGRALink is mapped to a CGRALink that is enabled (or disabled) as well.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 */
+    void findSymmetries(CGRA* t_cgra, DFG* t_dfg);
+
+		/** This function gets the symmetries that keep the current partial mapping unchanged, i.e., every mapped DFGNode is on a fixed CGRANode and the CGRALinks are occupied in the same way as their images.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_II : the value of II
+		 * @return : the indexes of the symmetries in m_symmetries
+		 */
+    list<int> getActiveSymmetries(CGRA* t_cgra, int t_II);
+
+		/** The number of the threads exhaustiveMap uses, it comes from the "dfsThreads" param in param.json, 1 means DFSMap runs in the current thread.
+		 */
+    int m_dfsThreads;
+
+		/** This function splits the top levels of the DFSMap search tree into subproblems and runs them on m_dfsThreads workers, each on a clone of the CGRA and a copy of this Mapper.
+		 * a subproblem is a prefix of the schedule (the DFGNodes and the paths), which is replayed by DFSMap on the clone of the worker.
+		 * the subproblems are dealt to the deques of the workers in the order of cost, a worker takes the subproblems from the front of its own deque, and steals from the back of the others once its deque is empty.
+		 * the first worker succeeding cancels the others through the shared token, and its mapping and MRRG are copied back to this Mapper and t_cgra.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : true if the DFG is mapped
+		 */
+    bool parallelDFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
+		/** True means DFSMap maps the most constrained DFGNode first, it comes from the "dfsDynamicOrdering" param in param.json.
+		 */
+    bool m_dfsDynamicOrdering;
+
+		/** This function chooses the DFGNode DFSMap maps next.
+		 * without m_dfsDynamicOrdering, it is the next DFGNode in m_dfsOrder after the mapped ones.
+		 * with m_dfsDynamicOrdering, it is the unmapped DFGNode, whose predecessors along the forward DFGEdges are all mapped, with the fewest free (CGRANode, slot) candidates. The candidates are the free FU slots within II on the CGRANodes supporting it, the earlier DFGNode in DFG wins the tie.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_mappedDFGNodes : the DFGNodes that have been mapped
+		 * @return : the DFGNode to map next, NULL if all the DFGNodes are mapped
+		 */
+    DFGNode* getNextDFSNode(CGRA* t_cgra, DFG* t_dfg, int t_II, list<DFGNode*>* t_mappedDFGNodes);
+
+		/** True means scheduleWithRollback and DFSMap reject the schedule that fails forwardCheck(), it comes from the "forwardChecking" param in param.json.
+		 */
+    bool m_forwardChecking;
+    int m_dfsForwardCheckRejections;
+
+		/** This function checks whether every unmapped predecessor and successor of the just scheduled t_dfgNode still has a feasible CGRANode.
+		 * an unmapped successor needs a CGRANode that it can occupy within II and that is reachable from the CGRANode of t_dfgNode over the CGRALinks that can still carry the data of t_dfgNode in some cycle within II.
+		 * an unmapped predecessor needs such a CGRANode from which the CGRANode of t_dfgNode is reachable over the CGRALinks with a free slot within II.
+		 * @param t_II : the value of II
+		 * @param t_dfgNode : the DFGNode just scheduled
+		 * @return : false if some unmapped neighbor of t_dfgNode has no feasible CGRANode
+		 */
+    bool forwardCheck(int t_II, DFGNode* t_dfgNode);
+
+		/** The number of the consecutive IIs exhaustiveMap searches in parallel threads, it comes from the "parallelIIs" param in param.json.
+		 */
+    int m_parallelIIs;
+
+		/** This function runs DFSMap (or parallelDFSMap) for one II within the budgets, and shows the statistics of the search.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the value of II
+		 * @param t_isStaticElasticCGRA : true mean is StaticElasticCGRA
+		 * @return : true if the DFG is mapped
+		 */
+    bool searchExhaustively(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
+		/** The number of partial mappings beamSearchMap keeps after each DFGNode is scheduled, it comes from the "beamWidth" param in param.json.
+		 */
+    int m_beamWidth;
+
+		/** This function counts the free CGRALink slots within II, which is the resource left for routing the unscheduled DFGNodes.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_II : the value of II
+		 * @return : the number of (CGRALink, cycle) pairs that are not occupied
+		 */
+    int getFreeLinkSlots(CGRA* t_cgra, int t_II);
+
+		/** The number of the seeded variants multiStartMap runs in parallel, it comes from the "multiStartCount" param in param.json.
+		 */
+    int m_multiStartCount;
+
+		/** The seed of the variant that wins in multiStartMap, -1 means the deterministic variant.
+		 */
+    int m_winningSeed;
+
+		/** This function checks the shared cancellation token, and the ones of the parent Mappers (m_cancelParent).
+		 * @return : true if another strategy has succeeded and the current mapping should stop
+		 */
+    bool isCancelled();
+
+		/** This function checks whether DFSMap should stop, i.e., the mapping is cancelled or the expansion budget or the time budget is used up.
+		 */
+    bool isSearchStopped();
+
+		/** This function gets the order to map the DFGNodes.
+		 * if m_randomSeed is not -1, the DFGNodes of the same level (the DFG is ordered by level in reorderInLongest()) are shuffled.
+		 * if m_recurrenceFirst is true, the recurrence cycles are moved to the front with placeRecurrencesFirst().
+		 * with the "swing" mapping order, it is getSwingOrder() instead.
+		 * @param t_dfg : the pointer to the DFG
+		 * @return : the list of DFGNodes in mapping order
+		 */
+		list<DFGNode*>* getMappingOrder(DFG* t_dfg);
+
+		/** This function copies the mapping result of another Mapper, whose CGRA is a clone of t_cgra.
+		 * the CGRANodes in the mapping are replaced by the ones with the same location in t_cgra.
+		 * @param t_mapper : the Mapper to copy from
+		 * @param t_cgra : the CGRA of this Mapper
+		 */
+		void copyMappingFrom(Mapper* t_mapper, CGRA* t_cgra);
+
   public:
 		/**The constructor function of class Mapper
-		 * use the C++ default construct function
+		 * init the mapping options by default value
+		 */
+    Mapper();
+
+		/**The function to set how many lower-ranked candidates heuristicMap tries when schedule() fails
+		 * the value comes from the "rollbackCandidates" param in param.json, 0 means give up the II at the first failure.
+		 * @param t_rollbackCandidates : the number of extra candidates
+		 */
+		void setRollbackCandidates(int t_rollbackCandidates);
+
+		/**The function to set the budget of iterativeModuloMap
+		 * the value comes from the "imsBudgetRatio" param in param.json.
+		 * @param t_imsBudgetRatio : the budget for each II is t_imsBudgetRatio * the number of DFGNodes
+		 */
+		void setIMSBudgetRatio(int t_imsBudgetRatio);
+
+		/**The function to set the iterations of the negotiated routing in heuristicMap
+		 * the value comes from the "pathFinderIterations" param in param.json, 0 disables the negotiated routing.
+		 * @param t_pathFinderIterations : the maximum number of rip-up-and-reroute iterations
+		 */
+		void setPathFinderIterations(int t_pathFinderIterations);
+
+		/**The function to set the options of annealingMap
+		 * @param t_iterations : the number of the perturbations for each II
+		 * @param t_temperature : the initial temperature
+		 * @param t_cooling : the temperature is multiplied by t_cooling after every (the number of DFGNodes) perturbations
+		 * @param t_seed : the seed of the random perturbations
+		 */
+		void setAnnealingOptions(int t_iterations, float t_temperature, float t_cooling, int t_seed);
+
+		/**The function to set the seed of the randomized mapping order
+		 * @param t_randomSeed : the seed, -1 means the order of DFG is used
+		 */
+		void setRandomSeed(int t_randomSeed);
+
+		/**The function to set the budget of DFSMap
+		 * the value comes from the "dfsExpansionBudget" param in param.json.
+		 * @param t_dfsExpansionBudget : the number of paths DFSMap can try to schedule for each II, 0 means no limit
+		 */
+		void setDFSExpansionBudget(int t_dfsExpansionBudget);
+
+		/**The function to set the wall-time budget of DFSMap
+		 * the value comes from the "dfsTimeBudget" param in param.json.
+		 * @param t_dfsTimeBudget : the seconds DFSMap can search for each II, 0 means no limit
+		 */
+		void setDFSTimeBudget(int t_dfsTimeBudget);
+
+		/**The function to enable the nogood learning of DFSMap
+		 * the value comes from the "dfsNogoodLearning" param in param.json.
+		 * @param t_dfsNogoodLearning : true means the candidates matching a failed signature are skipped, which makes exhaustiveMap faster but incomplete
+		 */
+		void setDFSNogoodLearning(bool t_dfsNogoodLearning);
+
+		/**The function to enable the symmetry breaking of DFSMap
+		 * the value comes from the "dfsSymmetryBreaking" param in param.json.
+		 * @param t_dfsSymmetryBreaking : true means only one of the symmetric candidates is explored while the partial mapping is symmetric
+		 */
+		void setDFSSymmetryBreaking(bool t_dfsSymmetryBreaking);
+
+		/**The function to set the number of the threads of exhaustiveMap
+		 * the value comes from the "dfsThreads" param in param.json.
+		 * @param t_dfsThreads : the number of the workers searching the subproblems, 1 means no parallel search
+		 */
+		void setDFSThreads(int t_dfsThreads);
+
+		/**The function to enable the most-constrained-first ordering of DFSMap
+		 * the value comes from the "dfsDynamicOrdering" param in param.json.
+		 * @param t_dfsDynamicOrdering : true means the DFGNode with the fewest free candidates is mapped first
+		 */
+		void setDFSDynamicOrdering(bool t_dfsDynamicOrdering);
+
+		/**The function to enable the forward checking after each schedule in heuristicMap, iterativeModuloMap and exhaustiveMap
+		 * the value comes from the "forwardChecking" param in param.json.
+		 * @param t_forwardChecking : true means the schedule leaving an unmapped neighbor without feasible CGRANode is rejected
+		 */
+		void setForwardChecking(bool t_forwardChecking);
+
+		/**The function to set the largest II the mapping functions try
+		 * the value comes from the "maxII" param in param.json.
+		 * @param t_maxII : the largest II, -1 means no limit
+		 */
+		void setMaxII(int t_maxII);
+
+		/**The function to set the number of the IIs exhaustiveMap searches in parallel
+		 * the value comes from the "parallelIIs" param in param.json.
+		 * @param t_parallelIIs : the number of the consecutive IIs searched at the same time, 1 means one II after another
+		 */
+		void setParallelIIs(int t_parallelIIs);
+
+		/**The function to enable or disable the A* routing in dijkstra_search() and tryToRoute()
+		 * the value comes from the "aStarRouting" param in param.json.
+		 * @param t_aStarRouting : true means the hop distances of the CGRA guide the routing search
+		 */
+		void setAStarRouting(bool t_aStarRouting);
+
+		/**The function to enable or disable the lazy evaluation of the candidate CGRANodes in scheduleWithRollback()
+		 * the value comes from the "lazyCandidateEvaluation" param in param.json.
+		 * @param t_lazyCandidateEvaluation : true means only the promising CGRANodes are routed
+		 */
+		void setLazyCandidateEvaluation(bool t_lazyCandidateEvaluation);
+
+		/**The function to set the weight of the congestion terms in the path cost
+		 * the value comes from the "congestionWeight" param in param.json.
+		 * @param t_congestionWeight : the weight, 0 means the congestion is ignored
 		 */
-    Mapper(){}
+		void setCongestionWeight(float t_congestionWeight);
+
+		/** The function to set the cost policy used to rank the candidate paths.
+		 * the value comes from the "costPolicy" param in param.json.
+		 * @param t_costPolicy : "heuristic", "congestion", "latency" or "register", the others fall back to "heuristic"
+		 */
+		void setCostPolicy(string t_costPolicy);
+
+		/** The function to set the order to map the DFGNodes in every mapping mode.
+		 * the value comes from the "mappingOrder" param in param.json.
+		 * @param t_mappingOrder : "level" (the order of DFG) or "swing" (getSwingOrder()), the others fall back to "level"
+		 */
+		void setMappingOrder(string t_mappingOrder);
+
+		/** The function to set how much later than its ASAP cycle a DFGNode without mapped neighbors starts in the swing order.
+		 * the value comes from the "swingSeedStretch" param in param.json.
+		 * @param t_swingSeedStretch : the factor of the ASAP cycle, 1 means the ASAP cycle
+		 */
+		void setSwingSeedStretch(int t_swingSeedStretch);
+
+		/** The function to set the weights of the terms in getPathCost(), the weights that are not given keep their defaults.
+		 * the value comes from the "costWeights" param in param.json.
+		 * @param t_costWeights : the map from "waiting", "singleTile", "fanoutPort", "sharedTile", "busyNeighbor", "memoryTile", "multicast", "freeLink", "presentFactor", "presentGrowth", "registerHold" or "sharedLink" to the weight, the negative weights are ignored
+		 */
+		void setCostWeights(map<string, double>* t_costWeights);
+
+		/** The function to set whether the routes of the same data form a multicast tree.
+		 * the value comes from the "multicastRouting" param in param.json.
+		 * @param t_multicastRouting : true means the routes branch from the CGRANodes the data already passes
+		 */
+		void setMulticastRouting(bool t_multicastRouting);
+
+		/** The function to set whether the recurrence cycles are placed before the rest of the DFG.
+		 * the value comes from the "recurrenceFirst" param in param.json.
+		 * @param t_recurrenceFirst : true means the recurrence cycles are mapped first and only within II
+		 */
+		void setRecurrenceFirst(bool t_recurrenceFirst);
+
+		/** The function to set whether heuristicMap() starts each II from the placement of the failed II.
+		 * the value comes from the "warmStart" param in param.json.
+		 * @param t_warmStart : true means the DFGNodes try their former CGRANodes first, and only the conflicts are repaired
+		 */
+		void setWarmStart(bool t_warmStart);
+
+		/**The function to set the beam width of beamSearchMap
+		 * the value comes from the "beamWidth" param in param.json.
+		 * @param t_beamWidth : the number of partial mappings kept after each step
+		 */
+		void setBeamWidth(int t_beamWidth);
+
+		/**The function to set the number of the variants of multiStartMap
+		 * the value comes from the "multiStartCount" param in param.json.
+		 * @param t_multiStartCount : the number of the seeded heuristicMap variants running in parallel
+		 */
+		void setMultiStartCount(int t_multiStartCount);
+
+		/**The function to get the seed that wins in multiStartMap
+		 * setting the "randomSeed" param in param.json to it reproduces the mapping in the heuristic mode.
+		 * @return : the winning seed, -1 means the deterministic order and tie-breaks
+		 */
+		int getWinningSeed();
 
 		/**get the ResMII 
 		 * ResMII is equal to the number of DFGNode divided by the number of FU in CGRA.
@@ -98,8 +945,75 @@ class Mapper {
 		 */
 		int heuristicMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
 
+		/**The function to do Mapping via exhaustive search (DFSMap)
+		 * the II is increased once the search for the current II fails or uses up the budgets, until m_maxII.
+		 * with m_parallelIIs larger than 1, the consecutive IIs are searched in parallel threads, each on a clone of the CGRA and a copy of this Mapper, and the smallest successful II is kept.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the smallest possible value of II
+		 * @param t_isStaticElasticCGRA : true mean is StaticElasticCGRA
+		 * @return : the II of the mapping, -1 if failed
+		 */
     int exhaustiveMap(CGRA*, DFG*, int, bool);
 
+		/**The function to do Mapping via iterative modulo scheduling (Rau's IMS)
+		 * the DFGNodes are taken in the order of t_dfg->nodes. When a DFGNode cannot be placed, the DFGNodes occupying its forced FU slot (and then its mapped neighbors) are evicted and go back to the unscheduled pool. The II is increased once the budget is used up.
+		 * @param t_caga : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the smallest possible value of II
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : the II of the mapping, -1 if failed
+		 */
+		int iterativeModuloMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
+		/**This function maps the DFG by simulated annealing on the placement.
+		 * 1. place every DFGNode with placeUnmapped() as the initial placement.
+		 * 2. perturb the placement by moving a random DFGNode to a random CGRANode and a nearby cycle that it can occupy in the MRRG, accept the move according to the change of getPlacementCost() and the temperature.
+		 * 3. once the placement has no timing violation, route it with negotiatedRoute(), so it fails at once if the "pathFinderIterations" param is 0.
+		 * 4. if the iterations are used up, try the next II.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the smallest possible value of II
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : the II of the mapping, -1 if failed
+		 */
+		int annealingMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
+		/**This function runs several mapping strategies concurrently for the same II, each on a clone of the CGRA and a copy of this Mapper.
+		 * the strategies are heuristicMap, heuristicMap in a randomized order, and exhaustiveMap bounded by the DFS expansion budget.
+		 * the first strategy succeeding cancels the others through the shared token, and its mapping and MRRG are copied back to this Mapper and t_cgra.
+		 * if all of them fail, try the next II.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the smallest possible value of II
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : the II of the mapping, -1 if failed
+		 */
+		int portfolioMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
+		/**This function maps the DFG by beam search over the partial mappings.
+		 * the DFGNodes are scheduled in the mapping order, each partial mapping in the beam is extended with its m_beamWidth cheapest paths, and the m_beamWidth extensions with the lowest rank survive.
+		 * the rank is the accumulated cost of getPathCost() minus the bonus of the free CGRALink slots, so it sits between heuristicMap (width 1) and exhaustiveMap.
+		 * a partial mapping is only recorded as its paths in schedule order (the paths are shared between the forks), the MRRG is rebuilt with replaySchedule() when the partial mapping is extended, and restored from a snapshot of the CGRA after each trial.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the smallest possible value of II
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : the II of the mapping, -1 if failed
+		 */
+		int beamSearchMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
+		/**This function runs m_multiStartCount variants of heuristicMap for the same II in parallel threads, each on a clone of the CGRA and a copy of this Mapper.
+		 * each variant has its own seed, which shuffles the DFGNodes of the same level and breaks the ties of the path costs randomly.
+		 * the first successful variant (in the order of the seeds) is kept and its seed is recorded, if all of them fail, try the next II.
+		 * @param t_cgra : the pointer to the CGRA 
+		 * @param t_dfg : the pointer to the DFG
+		 * @param t_II : the smallest possible value of II
+		 * @param t_isStaticElasticCGRA : is always false now
+		 * @return : the II of the mapping, -1 if failed
+		 */
+		int multiStartMap(CGRA* t_cgra, DFG* t_dfg, int t_II, bool t_isStaticElasticCGRA);
+
 		/**This function try to find a path from a CGRANode which map t_dfgNode's pre Node to the t_fu which will map t_dfgNode.if the path is found, return the path, else return NULL
 		 * @param t_caga : the pointer to the CGRA 
 		 * @param t_dfg : the pointer to the DFG
@@ -56,6 +56,36 @@ namespace {
       bool precisionAware           = false;
       bool heuristicMapping         = true;
       bool parameterizableCGRA      = false;
+      int rollbackCandidates        = 3;
+      string mappingMode            = "";
+      int imsBudgetRatio            = 6;
+      int pathFinderIterations      = 32;
+      int annealingIterations       = 20000;
+      float annealingTemperature    = 5.0;
+      float annealingCooling        = 0.95;
+      int annealingSeed             = 1;
+      int dfsExpansionBudget        = 0;
+      int dfsTimeBudget             = 0;
+      bool dfsNogoodLearning        = false;
+      bool dfsSymmetryBreaking      = true;
+      int dfsThreads                = 1;
+      bool dfsDynamicOrdering       = false;
+      bool forwardChecking          = false;
+      int maxII                     = -1;
+      int parallelIIs               = 1;
+      bool aStarRouting             = false;
+      bool lazyCandidateEvaluation  = false;
+      float congestionWeight        = 2.0;
+      string costPolicy             = "heuristic";
+      map<string, double>* costWeights = new map<string, double>(); //weights of the terms in the cost of the paths
+      bool multicastRouting         = false;
+      bool recurrenceFirst          = true;
+      string mappingOrder           = "level";
+      int swingSeedStretch          = 3;
+      bool warmStart                = false;
+      int beamWidth                 = 4;
+      int multiStartCount           = 4;
+      int randomSeed                = -1;
       map<string, int>* execLatency = new map<string, int>();	//lantancy of operations
       list<string>* pipelinedOpt    = new list<string>();	//operations support pipeline
       map<string, list<int>*>* additionalFunc = new map<string, list<int>*>(); //TODO:
@@ -126,6 +156,68 @@ namespace {
         precisionAware        = param["precisionAware"];
         heuristicMapping      = param["heuristicMapping"];
         parameterizableCGRA   = param["parameterizableCGRA"];
+				//the params below are optional, the default value is used if it is not in param.json
+        if (param.contains("rollbackCandidates"))
+          rollbackCandidates  = param["rollbackCandidates"];
+        if (param.contains("mappingMode"))
+          mappingMode         = param["mappingMode"];
+        if (param.contains("imsBudgetRatio"))
+          imsBudgetRatio      = param["imsBudgetRatio"];
+        if (param.contains("pathFinderIterations"))
+          pathFinderIterations = param["pathFinderIterations"];
+        if (param.contains("annealingIterations"))
+          annealingIterations = param["annealingIterations"];
+        if (param.contains("annealingTemperature"))
+          annealingTemperature = param["annealingTemperature"];
+        if (param.contains("annealingCooling"))
+          annealingCooling    = param["annealingCooling"];
+        if (param.contains("annealingSeed"))
+          annealingSeed       = param["annealingSeed"];
+        if (param.contains("dfsExpansionBudget"))
+          dfsExpansionBudget  = param["dfsExpansionBudget"];
+        if (param.contains("dfsTimeBudget"))
+          dfsTimeBudget       = param["dfsTimeBudget"];
+        if (param.contains("dfsNogoodLearning"))
+          dfsNogoodLearning   = param["dfsNogoodLearning"];
+        if (param.contains("dfsSymmetryBreaking"))
+          dfsSymmetryBreaking = param["dfsSymmetryBreaking"];
+        if (param.contains("dfsThreads"))
+          dfsThreads          = param["dfsThreads"];
+        if (param.contains("dfsDynamicOrdering"))
+          dfsDynamicOrdering  = param["dfsDynamicOrdering"];
+        if (param.contains("forwardChecking"))
+          forwardChecking     = param["forwardChecking"];
+        if (param.contains("maxII"))
+          maxII               = param["maxII"];
+        if (param.contains("parallelIIs"))
+          parallelIIs         = param["parallelIIs"];
+        if (param.contains("aStarRouting"))
+          aStarRouting        = param["aStarRouting"];
+        if (param.contains("lazyCandidateEvaluation"))
+          lazyCandidateEvaluation = param["lazyCandidateEvaluation"];
+        if (param.contains("congestionWeight"))
+          congestionWeight    = param["congestionWeight"];
+        if (param.contains("costPolicy"))
+          costPolicy          = param["costPolicy"];
+        if (param.contains("costWeights"))
+          for (auto& weight : param["costWeights"].items())
+            (*costWeights)[weight.key()] = weight.value();
+        if (param.contains("multicastRouting"))
+          multicastRouting    = param["multicastRouting"];
+        if (param.contains("recurrenceFirst"))
+          recurrenceFirst     = param["recurrenceFirst"];
+        if (param.contains("mappingOrder"))
+          mappingOrder        = param["mappingOrder"];
+        if (param.contains("swingSeedStretch"))
+          swingSeedStretch    = param["swingSeedStretch"];
+        if (param.contains("warmStart"))
+          warmStart           = param["warmStart"];
+        if (param.contains("beamWidth"))
+          beamWidth           = param["beamWidth"];
+        if (param.contains("multiStartCount"))
+          multiStartCount     = param["multiStartCount"];
+        if (param.contains("randomSeed"))
+          randomSeed          = param["randomSeed"];
 				//3. assign value to execLatency , piplinedOpt,additionalFunc
         for (auto& opt : param["optLatency"].items()) {
           cout<<opt.key()<<" : "<<opt.value()<<endl;
@@ -166,6 +258,36 @@ namespace {
       cgra->setCtrlMemConstraint(ctrlMemConstraint);
       cgra->setBypassConstraint(bypassConstraint);
       mapper = new Mapper();
+      mapper->setRollbackCandidates(rollbackCandidates);
+      mapper->setIMSBudgetRatio(imsBudgetRatio);
+      mapper->setPathFinderIterations(pathFinderIterations);
+      mapper->setAnnealingOptions(annealingIterations, annealingTemperature,
+                                  annealingCooling, annealingSeed);
+      mapper->setDFSExpansionBudget(dfsExpansionBudget);
+      mapper->setDFSTimeBudget(dfsTimeBudget);
+      mapper->setDFSNogoodLearning(dfsNogoodLearning);
+      mapper->setDFSSymmetryBreaking(dfsSymmetryBreaking);
+      mapper->setDFSThreads(dfsThreads);
+      mapper->setDFSDynamicOrdering(dfsDynamicOrdering);
+      mapper->setForwardChecking(forwardChecking);
+      mapper->setMaxII(maxII);
+      mapper->setParallelIIs(parallelIIs);
+      mapper->setAStarRouting(aStarRouting);
+      mapper->setLazyCandidateEvaluation(lazyCandidateEvaluation);
+      mapper->setCongestionWeight(congestionWeight);
+      mapper->setCostPolicy(costPolicy);
+      mapper->setCostWeights(costWeights);
+      mapper->setMulticastRouting(multicastRouting);
+      mapper->setRecurrenceFirst(recurrenceFirst);
+      mapper->setMappingOrder(mappingOrder);
+      mapper->setSwingSeedStretch(swingSeedStretch);
+      mapper->setWarmStart(warmStart);
+      mapper->setBeamWidth(beamWidth);
+      mapper->setMultiStartCount(multiStartCount);
+      mapper->setRandomSeed(randomSeed);
+      // "mappingMode" overrides "heuristicMapping" if it is given.
+      if (mappingMode == "")
+        mappingMode = heuristicMapping ? "heuristic" : "exhaustive";
 
       // Show the count of different opcodes (IRs).
       cout << "==================================\n";
@@ -202,12 +324,33 @@ namespace {
       bool success = false;
       if (!isStaticElasticCGRA) {
         cout << "==================================\n";
-        if (heuristicMapping) {
+        if (mappingMode == "heuristic") {
           cout << "[heuristic]\n";
           II = mapper->heuristicMap(cgra, dfg, II, isStaticElasticCGRA);
-        } else {
+        } else if (mappingMode == "ims") {
+          cout << "[iterative modulo scheduling]\n";
+          II = mapper->iterativeModuloMap(cgra, dfg, II, isStaticElasticCGRA);
+        } else if (mappingMode == "annealing") {
+          cout << "[simulated annealing]\n";
+          II = mapper->annealingMap(cgra, dfg, II, isStaticElasticCGRA);
+        } else if (mappingMode == "portfolio") {
+          cout << "[portfolio]\n";
+          II = mapper->portfolioMap(cgra, dfg, II, isStaticElasticCGRA);
+        } else if (mappingMode == "beam") {
+          cout << "[beam search]\n";
+          II = mapper->beamSearchMap(cgra, dfg, II, isStaticElasticCGRA);
+        } else if (mappingMode == "multistart") {
+          cout << "[multi-start heuristic]\n";
+          II = mapper->multiStartMap(cgra, dfg, II, isStaticElasticCGRA);
+          if (II != -1)
+            cout << "[Winning seed: " << mapper->getWinningSeed() << "]\n";
+        } else if (mappingMode == "exhaustive") {
           cout << "[exhaustive]\n";
           II = mapper->exhaustiveMap(cgra, dfg, II, isStaticElasticCGRA);
+        } else {
+          cout << "[error] unknown mappingMode \"" << mappingMode << "\" in param.json, expect heuristic, ims, annealing, portfolio, beam, multistart or exhaustive\n";
+          cout << "==================================\n";
+          return false;
         }
       }
 
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+# Tune the "costWeights" in param.json over the kernels.
+#
+# Every weight set maps each kernel at each fabric size, the mappings run in
+# parallel, each one in its own directory under build/tune. The weight set
+# with the fewest failures, then the lowest total II, then the lowest total
+# mapping time wins, and it is printed as a param.json fragment.
+#
+# usage: python3 scripts/tune.py [--so libmapperPass.so] [--sizes 2x2,3x3,4x4]
+#            [--mode random|sweep] [--samples 20] [kernels/*.cpp or *.bc]
+
+import argparse
+import concurrent.futures
+import json
+import math
+import os
+import random
+import re
+import shlex
+import shutil
+import subprocess
+import time
+
+WORK_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCRIPT_DIR = os.path.join(WORK_DIR, "scripts")
+BUILD_DIR = os.path.join(WORK_DIR, "build")
+
+# The defaults of the weights in Mapper::Mapper().
+DEFAULT_WEIGHTS = {
+  "waiting"      : 1.5,
+  "singleTile"   : 2,
+  "fanoutPort"   : 4,
+  "sharedTile"   : 0.5,
+  "busyNeighbor" : 0.4,
+  "memoryTile"   : 2,
+  "multicast"    : 0.5,
+  "freeLink"     : 0.3,
+  "presentFactor": 0.5,
+  "presentGrowth": 1.6,
+  "registerHold" : 0.2,
+  "sharedLink"   : 0.1,
+}
+
+# The factors the sweep mode tries on each weight in turn.
+SWEEP_FACTORS = [0, 0.5, 2]
+
+
+def compile_kernel(src):
+  name = os.path.splitext(os.path.basename(src))[0]
+  out_dir = os.path.join(BUILD_DIR, name)
+  bc = os.path.join(out_dir, name + ".bc")
+  ll = os.path.join(out_dir, name + ".ll")
+  if not os.path.exists(bc) or os.path.getmtime(bc) < os.path.getmtime(src):
+    os.makedirs(out_dir, exist_ok=True)
+    subprocess.check_call(["bash", os.path.join(SCRIPT_DIR, "compile.sh"),
+                           src, bc, ll])
+  return bc
+
+
+def get_kernel_name(bc):
+  # compile.sh keeps the disassembled .ll next to the .bc.
+  ll = os.path.splitext(bc)[0] + ".ll"
+  with open(ll) as f:
+    names = re.findall(r"^define .*@(_Z\d+kernel\w*)\(", f.read(), re.M)
+  if not names:
+    raise RuntimeError("no kernel function in " + ll)
+  return names[0]
+
+
+def get_fabric(size):
+  rows, columns = [int(x) for x in size.split("x")]
+  # The leftmost column does the loads and stores as in the default param.json.
+  memory = [i * columns for i in range(rows)]
+  return {"row": rows, "column": columns,
+          "additionalFunc": {"load": memory, "store": memory}}
+
+
+def map_kernel(args, base, weights, kernel, size, run_dir):
+  bc, name = kernel
+  param = dict(base)
+  param.update(get_fabric(size))
+  param["kernel"] = name
+  param["costWeights"] = weights
+  os.makedirs(run_dir, exist_ok=True)
+  with open(os.path.join(run_dir, "param.json"), "w") as f:
+    json.dump(param, f, indent=2)
+  command = shlex.split(args.opt) + ["-load", args.so, "-mapperPass", bc,
+                                     "-o", os.devnull]
+  start = time.time()
+  try:
+    out = subprocess.run(command, cwd=run_dir, stdout=subprocess.PIPE,
+                         stderr=subprocess.STDOUT, timeout=args.timeout,
+                         universal_newlines=True).stdout
+  except subprocess.TimeoutExpired:
+    out = ""
+  elapsed = time.time() - start
+  ii = re.findall(r"\[Mapping II: (\d+)\]", out)
+  return (int(ii[-1]) if ii else None), elapsed
+
+
+def evaluate(args, base, kernels, weights, index):
+  jobs = {}
+  with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+    for kernel in kernels:
+      stem = os.path.splitext(os.path.basename(kernel[0]))[0]
+      for size in args.sizes.split(","):
+        run_dir = os.path.join(BUILD_DIR, "tune", str(index),
+                               "%s_%s" % (stem, size))
+        jobs[(stem, size)] = pool.submit(map_kernel, args, base, weights,
+                                         kernel, size, run_dir)
+  failures, totalII, totalTime = 0, 0, 0.0
+  for key, job in sorted(jobs.items()):
+    ii, elapsed = job.result()
+    if ii is None:
+      failures += 1
+    else:
+      totalII += ii
+    totalTime += elapsed
+  if not args.keep:
+    shutil.rmtree(os.path.join(BUILD_DIR, "tune", str(index)),
+                  ignore_errors=True)
+  return failures, totalII, totalTime
+
+
+def get_fragment(weights):
+  width = max(len(key) for key in weights) + 2
+  lines = ['                              %-*s : %s' % (width, '"%s"' % key,
+           json.dumps(round(value, 3))) for key, value in weights.items()]
+  return ('  "costWeights"           : {\n' + ",\n".join(lines) +
+          '\n                            },')
+
+
+def main():
+  parser = argparse.ArgumentParser(description="tune the costWeights in param.json")
+  parser.add_argument("kernels", nargs="*",
+                      help=".cpp or .bc kernels, all of kernels/*.cpp by default")
+  parser.add_argument("--so", default=os.path.join(WORK_DIR, "..", "build", "src",
+                                                   "libmapperPass.so"))
+  parser.add_argument("--opt", default="opt-12", help="the opt command to load the pass")
+  parser.add_argument("--param", default=os.path.join(WORK_DIR, "param.json"))
+  parser.add_argument("--sizes", default="2x2,3x3,4x4", help="the fabric sizes, rowsxcolumns")
+  parser.add_argument("--mode", default="random", choices=["random", "sweep"])
+  parser.add_argument("--samples", type=int, default=20,
+                      help="the weight sets the random mode tries")
+  parser.add_argument("--scale", type=float, default=4,
+                      help="the random mode scales each weight by up to this factor either way")
+  parser.add_argument("--seed", type=int, default=1)
+  parser.add_argument("--jobs", type=int, default=os.cpu_count())
+  parser.add_argument("--timeout", type=int, default=60, help="seconds per mapping")
+  parser.add_argument("--output", default=os.path.join(BUILD_DIR, "tune", "costWeights.json"))
+  parser.add_argument("--keep", action="store_true", help="keep the mapping directories")
+  args = parser.parse_args()
+
+  with open(args.param) as f:
+    base = json.load(f)
+  sources = args.kernels or sorted(
+      os.path.join(WORK_DIR, "kernels", name)
+      for name in os.listdir(os.path.join(WORK_DIR, "kernels")) if name.endswith(".cpp"))
+  kernels = []
+  for source in sources:
+    bc = compile_kernel(source) if source.endswith(".cpp") else source
+    kernels.append((os.path.abspath(bc), get_kernel_name(bc)))
+
+  best = dict(DEFAULT_WEIGHTS)
+  best.update(base.get("costWeights", {}))
+  index = 0
+  bestScore = evaluate(args, base, kernels, best, index)
+  print("[tune] start: %d failures, total II %d, %.1fs" % bestScore)
+
+  def consider(weights):
+    nonlocal best, bestScore, index
+    index += 1
+    score = evaluate(args, base, kernels, weights, index)
+    improved = score < bestScore
+    print("[tune] %d: %d failures, total II %d, %.1fs%s %s" %
+          ((index,) + score + (" *" if improved else "", json.dumps(weights))))
+    if improved:
+      best, bestScore = weights, score
+
+  random.seed(args.seed)
+  if args.mode == "random":
+    for _ in range(args.samples):
+      logScale = math.log(args.scale)
+      consider({key: value * math.exp(random.uniform(-logScale, logScale))
+                for key, value in best.items()})
+  else:
+    for key in DEFAULT_WEIGHTS:
+      current = best[key]
+      for factor in SWEEP_FACTORS:
+        weights = dict(best)
+        weights[key] = current * factor
+        consider(weights)
+
+  fragment = get_fragment(best)
+  os.makedirs(os.path.dirname(args.output), exist_ok=True)
+  with open(args.output, "w") as f:
+    f.write(fragment + "\n")
+  print("[tune] best: %d failures, total II %d, %.1fs" % bestScore)
+  print(fragment)
+
+
+if __name__ == "__main__":
+  main()